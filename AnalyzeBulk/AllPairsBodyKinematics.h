@@ -0,0 +1,103 @@
+#ifndef OPENSIM_ALL_PAIRS_BODY_KINEMATICS_H_
+#define OPENSIM_ALL_PAIRS_BODY_KINEMATICS_H_
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  AllPairsBodyKinematics.h                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Simulation/Model/Analysis.h>
+#include <OpenSim/Simulation/SimbodyEngine/Body.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ColumnarTable.h"
+
+namespace OpenSim {
+
+/**
+ * Records, for every ordered pair (body, relative_to) of model bodies, what a
+ * PointKinematics analysis with the body origin as point and relative_to as
+ * the reference body records: the origin position expressed in relative_to,
+ * and its ground velocity and acceleration re-expressed in relative_to.
+ *
+ * Instead of one PointKinematics per pair, each of which realizes the state
+ * and queries both bodies every frame, the state is realized once per frame,
+ * every body's ground transform, origin velocity and origin acceleration is
+ * cached, and all pairs are filled from that cache into one wide table.
+ * Columns are named <body>-<relative_to>_<pos|vel|acc>_<X|Y|Z>.
+ *
+ * The table has bodies^2 * 9 columns, so it is written as a columnar binary
+ * file (<base>_AllPairsBodyKinematics.otc, see ColumnarTable.h) from which
+ * single body pairs can be loaded; the .sto text file is only written when
+ * write_text is set.
+ */
+class AllPairsBodyKinematics : public Analysis {
+    OpenSim_DECLARE_CONCRETE_OBJECT(AllPairsBodyKinematics, Analysis);
+
+public:
+    OpenSim_DECLARE_PROPERTY(include_accelerations, bool,
+            "Realize to Acceleration each frame and record accelerations. "
+            "Default true.");
+    OpenSim_DECLARE_PROPERTY(write_text, bool,
+            "Also export the results as a tab-separated .sto file next to the "
+            "columnar .otc file. Default false.");
+    OpenSim_DECLARE_PROPERTY(chunk_rows, int,
+            "Rows per chunk of the columnar file. Default 1024.");
+
+    AllPairsBodyKinematics();
+    explicit AllPairsBodyKinematics(Model* model);
+
+    void setModel(Model& model) override;
+
+    int begin(const SimTK::State& s) override;
+    int step(const SimTK::State& s, int stepNumber) override;
+    int end(const SimTK::State& s) override;
+
+    int printResults(const std::string& baseName, const std::string& dir = "",
+            double dT = -1.0,
+            const std::string& extension = ".sto") override;
+
+    const ColumnarTableWriter& getTable() const { return *_table; }
+
+    // Bodies in column order
+    const std::vector<const Body*>& getBodies() const { return _bodies; }
+
+private:
+    void constructProperties();
+    void setupTable();
+    int record(const SimTK::State& s);
+
+    std::vector<const Body*> _bodies;
+    // Per-frame cache, one entry per body
+    std::vector<SimTK::Transform> _groundTransforms;
+    std::vector<SimTK::Vec3> _originVelocities;
+    std::vector<SimTK::Vec3> _originAccelerations;
+    std::vector<double> _row;
+    // Rebuilt by setModel() on copies
+    SimTK::ResetOnCopy<std::unique_ptr<ColumnarTableWriter>> _table;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_ALL_PAIRS_BODY_KINEMATICS_H_
@@ -0,0 +1,91 @@
+#ifndef OPENSIM_ANALYSIS_PROGRESS_H_
+#define OPENSIM_ANALYSIS_PROGRESS_H_
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  AnalysisProgress.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+
+// Resumable progress of a bulk analysis run. Each finished task appends one
+// line, <setup hash>\t<input file>, and flushes it, so an interrupted run
+// loses at most the tasks in flight. A task counts as done only for the
+// setup it ran with: editing the analysis setup reruns everything.
+class AnalysisProgress {
+public:
+  AnalysisProgress(std::string fileName, const std::string &setupFile)
+      : _fileName(std::move(fileName)), _setupHash(hashFile(setupFile)) {
+    std::ifstream in(_fileName);
+    std::string line;
+    while (std::getline(in, line)) {
+      const std::size_t tab = line.find('\t');
+      if (tab != std::string::npos && line.compare(0, tab, _setupHash) == 0) {
+        _done.insert(line.substr(tab + 1));
+      }
+    }
+    _out.open(_fileName, std::ios::app);
+  }
+
+  bool isDone(const std::string &inputFile) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _done.count(inputFile) != 0;
+  }
+
+  void markDone(const std::string &inputFile) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_done.insert(inputFile).second) {
+      _out << _setupHash << '\t' << inputFile << std::endl;
+    }
+  }
+
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _done.size();
+  }
+
+private:
+  // FNV-1a of the file contents, as hex
+  static std::string hashFile(const std::string &fileName) {
+    std::ifstream in(fileName, std::ios::binary);
+    std::uint64_t hash = 14695981039346656037ull;
+    char c;
+    while (in.get(c)) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    std::ostringstream hex;
+    hex << std::hex << hash;
+    return hex.str();
+  }
+
+  std::string _fileName;
+  std::string _setupHash;
+  std::set<std::string> _done;
+  std::ofstream _out;
+  mutable std::mutex _mutex;
+};
+
+#endif // OPENSIM_ANALYSIS_PROGRESS_H_
@@ -0,0 +1,262 @@
+#ifndef OPENSIM_COLUMNAR_TABLE_H_
+#define OPENSIM_COLUMNAR_TABLE_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  ColumnarTable.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Common/Exception.h>
+#include <OpenSim/Common/STOFileAdapter.h>
+#include <OpenSim/Common/TimeSeriesTable.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Columnar binary tables for results too wide for tab-separated text (the
+// all-pairs kinematics are bodies^2 * 9 columns). Rows are grouped in chunks
+// of chunkRows; inside a chunk every column's values are contiguous, so one
+// column is read with one seek per chunk and the rest of the file is never
+// touched.
+//
+// Layout (native byte order):
+//   "OSIMCOLT" | uint32 version | uint32 chunkRows | uint64 nRows |
+//   uint64 nColumns | nColumns x (uint32 length, label bytes) |
+//   chunk 0: column 0 rows, column 1 rows, ... | chunk 1: ...
+// Column 0 is "time". Every chunk but the last holds chunkRows rows.
+const std::string columnarExtension = ".otc";
+
+namespace columnar_detail {
+const char magic[8] = {'O', 'S', 'I', 'M', 'C', 'O', 'L', 'T'};
+const std::uint32_t version = 1;
+
+template <typename T> void writeRaw(std::ostream& out, const T& v) {
+    out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+template <typename T> void readRaw(std::istream& in, T& v) {
+    in.read(reinterpret_cast<char*>(&v), sizeof(T));
+}
+} // namespace columnar_detail
+
+// Collects rows in the on-disk chunk layout and writes them in one go
+class ColumnarTableWriter {
+public:
+    // `labels` are the data columns; "time" is added in front
+    explicit ColumnarTableWriter(const std::vector<std::string>& labels,
+                                 std::uint32_t chunkRows = 1024)
+            : _chunkRows(std::max<std::uint32_t>(chunkRows, 1)) {
+        _labels.reserve(labels.size() + 1);
+        _labels.push_back("time");
+        _labels.insert(_labels.end(), labels.begin(), labels.end());
+    }
+
+    // `values` holds one value per data column
+    void appendRow(double time, const double* values) {
+        const std::size_t nColumns = _labels.size();
+        const std::size_t r = _nRows % _chunkRows;
+        if (r == 0) _chunks.emplace_back(std::size_t(_chunkRows) * nColumns);
+        double* chunk = _chunks.back().data();
+        chunk[r] = time;
+        for (std::size_t c = 1; c < nColumns; ++c) {
+            chunk[c * _chunkRows + r] = values[c - 1];
+        }
+        ++_nRows;
+    }
+
+    void clear() {
+        _chunks.clear();
+        _nRows = 0;
+    }
+
+    std::size_t getNumRows() const { return _nRows; }
+    const std::vector<std::string>& getColumnLabels() const { return _labels; }
+
+    void write(const std::string& fileName) const {
+        using namespace columnar_detail;
+        std::ofstream out(fileName, std::ios::binary);
+        OPENSIM_THROW_IF(!out, OpenSim::Exception, "Cannot write " + fileName);
+        out.write(magic, sizeof(magic));
+        writeRaw(out, version);
+        writeRaw(out, _chunkRows);
+        writeRaw(out, static_cast<std::uint64_t>(_nRows));
+        writeRaw(out, static_cast<std::uint64_t>(_labels.size()));
+        for (const std::string& label : _labels) {
+            writeRaw(out, static_cast<std::uint32_t>(label.size()));
+            out.write(label.data(), label.size());
+        }
+        for (std::size_t k = 0; k < _chunks.size(); ++k) {
+            const std::size_t rows =
+                    std::min<std::size_t>(_chunkRows, _nRows - k * _chunkRows);
+            for (std::size_t c = 0; c < _labels.size(); ++c) {
+                out.write(reinterpret_cast<const char*>(
+                                  _chunks[k].data() + c * _chunkRows),
+                          rows * sizeof(double));
+            }
+        }
+        OPENSIM_THROW_IF(!out, OpenSim::Exception, "Failed writing " + fileName);
+    }
+
+private:
+    std::vector<std::string> _labels;
+    std::uint32_t _chunkRows;
+    std::size_t _nRows = 0;
+    std::vector<std::vector<double>> _chunks;
+};
+
+// Reads the header on construction and columns on demand
+class ColumnarTableReader {
+public:
+    explicit ColumnarTableReader(const std::string& fileName)
+            : _fileName(fileName) {
+        using namespace columnar_detail;
+        std::ifstream in(fileName, std::ios::binary);
+        char fileMagic[sizeof(magic)] = {};
+        in.read(fileMagic, sizeof(fileMagic));
+        std::uint32_t fileVersion = 0;
+        readRaw(in, fileVersion);
+        OPENSIM_THROW_IF(!in || !std::equal(magic, magic + sizeof(magic), fileMagic) ||
+                                 fileVersion != version,
+                OpenSim::Exception, fileName + " is not a columnar table");
+        std::uint64_t nRows = 0, nColumns = 0;
+        readRaw(in, _chunkRows);
+        readRaw(in, nRows);
+        readRaw(in, nColumns);
+        _nRows = static_cast<std::size_t>(nRows);
+        _labels.resize(static_cast<std::size_t>(nColumns));
+        for (std::size_t c = 0; c < _labels.size(); ++c) {
+            std::uint32_t length = 0;
+            readRaw(in, length);
+            _labels[c].resize(length);
+            in.read(&_labels[c][0], length);
+            _index[_labels[c]] = c;
+        }
+        OPENSIM_THROW_IF(!in || _chunkRows == 0, OpenSim::Exception,
+                "Truncated header in " + fileName);
+        _dataStart = in.tellg();
+    }
+
+    // "time" first, then the data columns
+    const std::vector<std::string>& getColumnLabels() const { return _labels; }
+    std::size_t getNumRows() const { return _nRows; }
+    std::uint32_t getChunkRows() const { return _chunkRows; }
+
+    std::vector<double> readColumn(std::size_t column) const {
+        std::ifstream in(_fileName, std::ios::binary);
+        std::vector<double> values(_nRows);
+        readColumn(in, column, values.data());
+        return values;
+    }
+
+    std::vector<double> readColumn(const std::string& label) const {
+        const auto it = _index.find(label);
+        OPENSIM_THROW_IF(it == _index.end(), OpenSim::Exception,
+                "No column " + label + " in " + _fileName);
+        return readColumn(it->second);
+    }
+
+    // `labels` only (all data columns if empty), one pass over the chunks
+    OpenSim::TimeSeriesTable readTable(
+            std::vector<std::string> labels = {}) const {
+        if (labels.empty()) labels.assign(_labels.begin() + 1, _labels.end());
+        std::ifstream in(_fileName, std::ios::binary);
+        std::vector<double> column(_nRows);
+        readColumn(in, 0, column.data());
+        SimTK::Matrix values(static_cast<int>(_nRows),
+                             static_cast<int>(labels.size()));
+        for (std::size_t j = 0; j < labels.size(); ++j) {
+            const auto it = _index.find(labels[j]);
+            OPENSIM_THROW_IF(it == _index.end(), OpenSim::Exception,
+                    "No column " + labels[j] + " in " + _fileName);
+            std::vector<double> data(_nRows);
+            readColumn(in, it->second, data.data());
+            for (std::size_t r = 0; r < _nRows; ++r) {
+                values(static_cast<int>(r), static_cast<int>(j)) = data[r];
+            }
+        }
+        return OpenSim::TimeSeriesTable(column, values, labels);
+    }
+
+private:
+    void readColumn(std::ifstream& in, std::size_t column, double* out) const {
+        const std::size_t nColumns = _labels.size();
+        for (std::size_t first = 0; first < _nRows; first += _chunkRows) {
+            const std::size_t rows =
+                    std::min<std::size_t>(_chunkRows, _nRows - first);
+            const std::streamoff offset = _dataStart +
+                    std::streamoff((first * nColumns + column * rows) *
+                                   sizeof(double));
+            in.seekg(offset);
+            in.read(reinterpret_cast<char*>(out + first), rows * sizeof(double));
+        }
+        OPENSIM_THROW_IF(!in, OpenSim::Exception,
+                "Truncated data in " + _fileName);
+    }
+
+    std::string _fileName;
+    std::uint32_t _chunkRows = 0;
+    std::size_t _nRows = 0;
+    std::vector<std::string> _labels;
+    std::map<std::string, std::size_t> _index;
+    std::streamoff _dataStart = 0;
+};
+
+// Tab-separated export, for tools that only read text
+inline void exportColumnarTableToSto(const std::string& columnarFile,
+                                     const std::string& stoFile) {
+    OpenSim::TimeSeriesTable table = ColumnarTableReader(columnarFile).readTable();
+    table.addTableMetaData<std::string>("inDegrees", "no");
+    OpenSim::STOFileAdapter::write(table, stoFile);
+}
+
+// Rows of `inputs` (same columns, in order) into one table with the chunk
+// size of the first, so the result has the bytes of a single serial write
+inline void concatenateColumnarTables(const std::vector<std::string>& inputs,
+                                      const std::string& output) {
+    OPENSIM_THROW_IF(inputs.empty(), OpenSim::Exception, "Nothing to concatenate");
+    const ColumnarTableReader first(inputs.front());
+    const std::vector<std::string>& labels = first.getColumnLabels();
+    ColumnarTableWriter writer(
+            std::vector<std::string>(labels.begin() + 1, labels.end()),
+            first.getChunkRows());
+    std::vector<double> row(labels.size() - 1);
+    for (const std::string& input : inputs) {
+        const ColumnarTableReader reader(input);
+        OPENSIM_THROW_IF(reader.getColumnLabels() != labels, OpenSim::Exception,
+                input + " has different columns than " + inputs.front());
+        std::vector<std::vector<double>> columns(labels.size());
+        for (std::size_t c = 0; c < labels.size(); ++c) {
+            columns[c] = reader.readColumn(c);
+        }
+        for (std::size_t r = 0; r < reader.getNumRows(); ++r) {
+            for (std::size_t c = 1; c < labels.size(); ++c) {
+                row[c - 1] = columns[c][r];
+            }
+            writer.appendRow(columns[0][r], row.data());
+        }
+    }
+    writer.write(output);
+}
+
+#endif // OPENSIM_COLUMNAR_TABLE_H_
@@ -0,0 +1,308 @@
+#ifndef OPENSIM_COORDINATE_SPLINE_CACHE_H_
+#define OPENSIM_COORDINATE_SPLINE_CACHE_H_
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  CoordinateSplineCache.h                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Common/GCVSplineSet.h>
+#include <OpenSim/Common/TableUtilities.h>
+#include <OpenSim/Common/TimeSeriesTable.h>
+#include <OpenSim/Simulation/Model/Model.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// How speeds and accelerations are derived from a coordinates file, as in the
+// AnalyzeTool setup (lowpass_cutoff_frequency_for_coordinates, -1 for none)
+struct CoordinateSplineSettings {
+  double lowpassCutoffFrequency = -1;
+  int splineDegree = 5;
+};
+
+// Coordinate values, speeds and accelerations of a motion for one model, one
+// row per frame and one column per coordinate. q is the motion itself (as in
+// AnalyzeTool, after the optional low-pass filter); qdot and qddot are
+// derivatives of GCV splines fitted to it.
+struct CoordinateKinematics {
+  std::vector<double> times;
+  std::vector<std::string> coordinates; // model coordinate names
+  SimTK::Matrix q;
+  SimTK::Matrix qdot;
+  SimTK::Matrix qddot;
+};
+
+inline CoordinateKinematics
+computeCoordinateKinematics(const OpenSim::Model &model,
+                            const std::string &coordinatesFile,
+                            const CoordinateSplineSettings &settings = {}) {
+  OpenSim::TimeSeriesTable table(coordinatesFile);
+  const auto &meta = table.getTableMetaData();
+  const bool inDegrees =
+      meta.hasKey("inDegrees") &&
+      meta.getValueForKey("inDegrees").getValue<std::string>() == "yes";
+
+  CoordinateKinematics kin;
+  const OpenSim::CoordinateSet &coordinateSet = model.getCoordinateSet();
+  std::vector<std::string> labels;
+  for (const std::string &label : table.getColumnLabels()) {
+    if (!coordinateSet.contains(label)) {
+      continue;
+    }
+    labels.push_back(label);
+    if (inDegrees && coordinateSet.get(label).getMotionType() ==
+                         OpenSim::Coordinate::Rotational) {
+      table.updDependentColumn(label) *= SimTK_DEGREE_TO_RADIAN;
+    }
+  }
+  kin.coordinates = labels;
+  if (settings.lowpassCutoffFrequency > 0) {
+    OpenSim::TableUtilities::filterLowpass(
+        table, settings.lowpassCutoffFrequency, true);
+  }
+  kin.times = table.getIndependentColumn();
+
+  const int nRows = static_cast<int>(kin.times.size());
+  const int nCols = static_cast<int>(labels.size());
+  kin.q.resize(nRows, nCols);
+  kin.qdot.resize(nRows, nCols);
+  kin.qddot.resize(nRows, nCols);
+  const OpenSim::GCVSplineSet splines(table, labels, settings.splineDegree);
+  for (int c = 0; c < nCols; ++c) {
+    const auto column = table.getDependentColumn(labels[c]);
+    for (int r = 0; r < nRows; ++r) {
+      kin.q(r, c) = column[r];
+      kin.qdot(r, c) = splines.evaluate(c, 1, kin.times[r]);
+      kin.qddot(r, c) = splines.evaluate(c, 2, kin.times[r]);
+    }
+  }
+  return kin;
+}
+
+// Spline fits of coordinate files shared between tools and runs. An entry is
+// keyed by an FNV-1a hash of the file contents, the model's coordinates
+// (names and whether they are rotational, which decide the columns and unit
+// conversion) and the settings, so an edited file or a different filter
+// never hits a stale entry. Entries hold what every consumer evaluates: the
+// spline values and first two derivatives at the sample times, as raw
+// doubles (native byte order) in <directory>/<key>.spl. Safe to use from
+// several threads and processes: entries are written to a temporary file and
+// renamed into place.
+class CoordinateSplineCache {
+public:
+  explicit CoordinateSplineCache(std::filesystem::path directory)
+      : _directory(std::move(directory)) {
+    std::filesystem::create_directories(_directory);
+  }
+
+  // Cached kinematics of `coordinatesFile` for `model`, computed and stored
+  // on a miss
+  CoordinateKinematics get(const OpenSim::Model &model,
+                           const std::string &coordinatesFile,
+                           const CoordinateSplineSettings &settings = {}) {
+    const std::uint64_t key = makeKey(model, coordinatesFile, settings);
+    const std::filesystem::path entry = entryPath(key);
+    CoordinateKinematics kin;
+    if (load(entry, key, kin)) {
+      ++_hits;
+      return kin;
+    }
+    ++_misses;
+    kin = computeCoordinateKinematics(model, coordinatesFile, settings);
+    store(entry, key, kin);
+    return kin;
+  }
+
+  std::size_t hits() const { return _hits; }
+  std::size_t misses() const { return _misses; }
+
+  static std::uint64_t makeKey(const OpenSim::Model &model,
+                               const std::string &coordinatesFile,
+                               const CoordinateSplineSettings &settings) {
+    std::ifstream file(coordinatesFile, std::ios::binary);
+    OPENSIM_THROW_IF(!file, OpenSim::Exception,
+                     "Cannot read coordinates file " + coordinatesFile);
+    std::uint64_t hash = fnvOffset;
+    char buffer[1 << 16];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+      hash = fnv1a(buffer, static_cast<std::size_t>(file.gcount()), hash);
+    }
+    const OpenSim::CoordinateSet &coordinateSet = model.getCoordinateSet();
+    for (int i = 0; i < coordinateSet.getSize(); ++i) {
+      const OpenSim::Coordinate &coordinate = coordinateSet.get(i);
+      const std::string &name = coordinate.getName();
+      hash = fnv1a(name.data(), name.size() + 1, hash);
+      const bool rotational =
+          coordinate.getMotionType() == OpenSim::Coordinate::Rotational;
+      hash = fnv1a(&rotational, sizeof(rotational), hash);
+    }
+    hash = fnv1a(&settings.lowpassCutoffFrequency,
+                 sizeof(settings.lowpassCutoffFrequency), hash);
+    hash = fnv1a(&settings.splineDegree, sizeof(settings.splineDegree), hash);
+    return fnv1a(&formatVersion, sizeof(formatVersion), hash);
+  }
+
+private:
+  static constexpr std::uint64_t fnvOffset = 14695981039346656037ull;
+  static constexpr std::uint64_t fnvPrime = 1099511628211ull;
+  static constexpr std::uint32_t formatVersion = 1;
+  static constexpr char magic[8] = {'O', 'S', 'I', 'M', 'S', 'P', 'L', '\0'};
+
+  static std::uint64_t fnv1a(const void *data, std::size_t size,
+                             std::uint64_t hash) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+      hash = (hash ^ bytes[i]) * fnvPrime;
+    }
+    return hash;
+  }
+
+  std::filesystem::path entryPath(std::uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.spl",
+                  static_cast<unsigned long long>(key));
+    return _directory / name;
+  }
+
+  template <typename T> static void writeRaw(std::ostream &out, const T &v) {
+    out.write(reinterpret_cast<const char *>(&v), sizeof(T));
+  }
+  template <typename T> static bool readRaw(std::istream &in, T &v) {
+    return bool(in.read(reinterpret_cast<char *>(&v), sizeof(T)));
+  }
+
+  static void writeMatrix(std::ostream &out, const SimTK::Matrix &m) {
+    std::vector<double> rowMajor(std::size_t(m.nrow()) * m.ncol());
+    for (int r = 0; r < m.nrow(); ++r) {
+      for (int c = 0; c < m.ncol(); ++c) {
+        rowMajor[std::size_t(r) * m.ncol() + c] = m(r, c);
+      }
+    }
+    out.write(reinterpret_cast<const char *>(rowMajor.data()),
+              rowMajor.size() * sizeof(double));
+  }
+  static bool readMatrix(std::istream &in, int nRows, int nCols,
+                         SimTK::Matrix &m) {
+    std::vector<double> rowMajor(std::size_t(nRows) * nCols);
+    if (!in.read(reinterpret_cast<char *>(rowMajor.data()),
+                 rowMajor.size() * sizeof(double))) {
+      return false;
+    }
+    m.resize(nRows, nCols);
+    for (int r = 0; r < nRows; ++r) {
+      for (int c = 0; c < nCols; ++c) {
+        m(r, c) = rowMajor[std::size_t(r) * nCols + c];
+      }
+    }
+    return true;
+  }
+
+  // False (recompute) for missing, truncated or foreign entries
+  static bool load(const std::filesystem::path &entry, std::uint64_t key,
+                   CoordinateKinematics &kin) {
+    std::ifstream in(entry, std::ios::binary);
+    if (!in) {
+      return false;
+    }
+    char fileMagic[sizeof(magic)];
+    std::uint64_t fileKey = 0;
+    std::int64_t nRows = 0, nCols = 0;
+    if (!in.read(fileMagic, sizeof(fileMagic)) ||
+        !std::equal(std::begin(magic), std::end(magic), fileMagic) ||
+        !readRaw(in, fileKey) || fileKey != key || !readRaw(in, nRows) ||
+        !readRaw(in, nCols)) {
+      return false;
+    }
+    kin.coordinates.resize(nCols);
+    for (std::string &name : kin.coordinates) {
+      std::uint32_t length = 0;
+      if (!readRaw(in, length)) {
+        return false;
+      }
+      name.resize(length);
+      if (!in.read(name.data(), length)) {
+        return false;
+      }
+    }
+    kin.times.resize(nRows);
+    return bool(in.read(reinterpret_cast<char *>(kin.times.data()),
+                        nRows * sizeof(double))) &&
+           readMatrix(in, int(nRows), int(nCols), kin.q) &&
+           readMatrix(in, int(nRows), int(nCols), kin.qdot) &&
+           readMatrix(in, int(nRows), int(nCols), kin.qddot);
+  }
+
+  static void store(const std::filesystem::path &entry, std::uint64_t key,
+                    const CoordinateKinematics &kin) {
+    std::ostringstream suffix;
+    // Process and thread id: thread ids alone repeat across processes
+    suffix << ".tmp" << ::getpid() << '_'
+           << std::hash<std::thread::id>()(std::this_thread::get_id());
+    std::filesystem::path temporary = entry;
+    temporary += suffix.str();
+    bool ok = false;
+    {
+      std::ofstream out(temporary, std::ios::binary);
+      out.write(magic, sizeof(magic));
+      writeRaw(out, key);
+      writeRaw(out, static_cast<std::int64_t>(kin.times.size()));
+      writeRaw(out, static_cast<std::int64_t>(kin.coordinates.size()));
+      for (const std::string &name : kin.coordinates) {
+        writeRaw(out, static_cast<std::uint32_t>(name.size()));
+        out.write(name.data(), name.size());
+      }
+      out.write(reinterpret_cast<const char *>(kin.times.data()),
+                kin.times.size() * sizeof(double));
+      writeMatrix(out, kin.q);
+      writeMatrix(out, kin.qdot);
+      writeMatrix(out, kin.qddot);
+      ok = bool(out);
+    }
+    std::error_code ec;
+    if (!ok) {
+      std::filesystem::remove(temporary, ec);
+      return;
+    }
+    std::filesystem::rename(temporary, entry, ec);
+    if (ec) {
+      std::filesystem::remove(temporary, ec);
+    }
+  }
+
+  std::filesystem::path _directory;
+  std::atomic<std::size_t> _hits{0};
+  std::atomic<std::size_t> _misses{0};
+};
+
+#endif // OPENSIM_COORDINATE_SPLINE_CACHE_H_
@@ -0,0 +1,118 @@
+#ifndef OPENSIM_PARTICIPANT_MODEL_CACHE_H_
+#define OPENSIM_PARTICIPANT_MODEL_CACHE_H_
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  ParticipantModelCache.h                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Simulation/Model/Model.h>
+
+#include "IMUPlacementDelta.h"
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Parsed models of the participants being analyzed. Every model file (.osim,
+// or the base model of an .imudelta) is parsed once; tasks get a clone. The
+// caller announces each task of a participant up front with expect() and
+// calls release() when it is done, and the participant's models are freed
+// with its last task, so memory stays bounded by the participants in flight.
+class ParticipantModelCache {
+public:
+  void expect(const std::string &participant) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_participants[participant].pendingTasks;
+  }
+
+  // A private copy of `modelFile` for one task of `participant`; IMU
+  // placement deltas are applied onto a clone of their base model
+  std::unique_ptr<OpenSim::Model> acquire(const std::string &participant,
+                                          const std::filesystem::path &modelFile) {
+    const bool isDelta = modelFile.extension() == imuDeltaExtension;
+    IMUPlacementDelta delta;
+    if (isDelta) {
+      delta = readIMUDelta(modelFile.string());
+    }
+    const std::string parsedFile = isDelta ? delta.baseModel : modelFile.string();
+    std::shared_ptr<ParsedModel> parsed;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      std::shared_ptr<ParsedModel> &slot =
+          _participants[participant].models[parsedFile];
+      if (!slot) {
+        slot = std::make_shared<ParsedModel>();
+      }
+      parsed = slot;
+    }
+    // Parsed outside the cache lock, so other files load concurrently; tasks
+    // of the same file wait here for the first. A throwing parse leaves the
+    // flag unset and the next task retries.
+    std::call_once(parsed->once, [&] {
+      parsed->model = std::make_unique<OpenSim::Model>(parsedFile);
+      std::lock_guard<std::mutex> lock(_mutex);
+      ++_parsed;
+    });
+    std::unique_ptr<OpenSim::Model> model;
+    {
+      // Copying reads the cached model's components
+      std::lock_guard<std::mutex> lock(_mutex);
+      model.reset(parsed->model->clone());
+    }
+    if (isDelta) {
+      applyIMUDelta(*model, delta);
+    }
+    return model;
+  }
+
+  void release(const std::string &participant) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _participants.find(participant);
+    if (it != _participants.end() && --it->second.pendingTasks <= 0) {
+      _participants.erase(it);
+    }
+  }
+
+  // Model files parsed so far
+  std::size_t parsed() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _parsed;
+  }
+
+private:
+  struct ParsedModel {
+    std::once_flag once;
+    std::unique_ptr<OpenSim::Model> model;
+  };
+  struct Participant {
+    int pendingTasks = 0;
+    // Shared, so a release() during a parse does not free the entry
+    std::map<std::string, std::shared_ptr<ParsedModel>> models;
+  };
+  std::map<std::string, Participant> _participants;
+  std::size_t _parsed = 0;
+  mutable std::mutex _mutex;
+};
+
+#endif // OPENSIM_PARTICIPANT_MODEL_CACHE_H_
@@ -0,0 +1,320 @@
+/* -------------------------------------------------------------------------- *
+ *                            OpenSim:  main.cpp                              *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/STOFileAdapter.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Tools/AnalyzeTool.h>
+
+// Thread Pool
+#include "BS_thread_pool.hpp" // BS::synced_stream, BS::thread_pool
+#include "AllPairsBodyKinematics.h"
+#include "AnalysisProgress.h"
+#include "CoordinateSplineCache.h"
+#include "ParticipantModelCache.h"
+
+#include <algorithm>
+#include <chrono> // for std::chrono functions
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Runs one AnalyzeTool setup (its analysis set, filter and equilibrium
+// settings) over every IK output of IMUIKBulk and MarkerIKBulk under a
+// results directory, writing each trial's results beside its .mot. Models
+// are parsed once per participant, speeds and accelerations come from the
+// shared coordinate spline cache, and finished trials are recorded so an
+// interrupted run picks up where it stopped.
+
+// Logging output
+const int64_t time_now =
+    std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch())
+        .count();
+std::ofstream log_file("task-" + std::to_string(time_now) + ".log");
+BS::synced_stream sync_out(std::cout, log_file);
+
+const std::string progressFileName = "analyze_bulk_progress.tsv";
+const std::vector<std::string> ikOutputSuffixes = {"_imu_ik_output.mot",
+                                                   "_marker_ik_output.mot"};
+const std::string sep = "_";
+
+struct IKOutput {
+  std::filesystem::path motion;
+  std::filesystem::path model;
+  std::string participant;
+};
+
+// model_file of the IK setup printed beside the motion (MarkerIKBulk), if it
+// names an existing model
+std::optional<std::filesystem::path>
+modelFromSetup(const std::filesystem::path &motion) {
+  std::filesystem::path setup = motion;
+  setup.replace_extension(".xml");
+  std::ifstream in(setup);
+  if (!in) {
+    return std::nullopt;
+  }
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+  const std::string text = buffer.str();
+  static const std::regex modelFile(
+      R"(<model_file>\s*([^<]*?)\s*</model_file>)");
+  std::smatch match;
+  if (!std::regex_search(text, match, modelFile) || match[1].length() == 0) {
+    return std::nullopt;
+  }
+  std::filesystem::path model = match[1].str();
+  if (model.is_relative()) {
+    model = setup.parent_path() / model;
+  }
+  if (!std::filesystem::exists(model)) {
+    return std::nullopt;
+  }
+  return model;
+}
+
+// Calibrated model in the motion's directory (IMUIKBulk names its output
+// <model stem>_<weight set>_imu_ik_output.mot): the .osim or .imudelta with
+// the longest stem that prefixes the motion's file name
+std::optional<std::filesystem::path>
+modelBeside(const std::filesystem::path &motion) {
+  const std::string motionName = motion.filename().string();
+  std::optional<std::filesystem::path> best;
+  for (const auto &entry :
+       std::filesystem::directory_iterator(motion.parent_path())) {
+    const std::filesystem::path &path = entry.path();
+    if (!entry.is_regular_file() ||
+        (path.extension() != ".osim" && path.extension() != imuDeltaExtension)) {
+      continue;
+    }
+    const std::string stem = path.stem().string() + sep;
+    if (motionName.starts_with(stem) &&
+        (!best || stem.size() > best->stem().string().size() + 1)) {
+      best = path;
+    }
+  }
+  return best;
+}
+
+std::vector<IKOutput> discoverIKOutputs(const std::filesystem::path &root) {
+  std::vector<IKOutput> outputs;
+  for (const auto &entry :
+       std::filesystem::recursive_directory_iterator(root)) {
+    const std::string name = entry.path().filename().string();
+    if (!entry.is_regular_file() ||
+        std::none_of(ikOutputSuffixes.begin(), ikOutputSuffixes.end(),
+                     [&](const std::string &suffix) {
+                       return name.ends_with(suffix);
+                     })) {
+      continue;
+    }
+    std::optional<std::filesystem::path> model = modelFromSetup(entry.path());
+    if (!model) {
+      model = modelBeside(entry.path());
+    }
+    if (!model) {
+      sync_out.println("No model found for: ", entry.path().string());
+      continue;
+    }
+    // <results>/<participant>/<trial>/<file>
+    outputs.push_back({entry.path(), *model,
+                       entry.path().parent_path().parent_path().filename().string()});
+  }
+  // Grouped by participant so its models are freed as soon as it is done
+  std::sort(outputs.begin(), outputs.end(),
+            [](const IKOutput &a, const IKOutput &b) {
+              return std::tie(a.participant, a.motion) <
+                     std::tie(b.participant, b.motion);
+            });
+  return outputs;
+}
+
+// Coordinate values and speeds of `kin` as a states file with absolute state
+// names; AnalyzeTool fills the remaining states with the model's defaults
+void writeStates(const OpenSim::Model &model, const CoordinateKinematics &kin,
+                 const std::filesystem::path &statesFile) {
+  const int nRows = static_cast<int>(kin.times.size());
+  const int nCoordinates = static_cast<int>(kin.coordinates.size());
+  std::vector<std::string> labels;
+  SimTK::Matrix states(nRows, 2 * nCoordinates);
+  for (int c = 0; c < nCoordinates; ++c) {
+    const std::string path =
+        model.getCoordinateSet().get(kin.coordinates[c]).getAbsolutePathString();
+    labels.push_back(path + "/value");
+    labels.push_back(path + "/speed");
+    for (int r = 0; r < nRows; ++r) {
+      states(r, 2 * c) = kin.q(r, c);
+      states(r, 2 * c + 1) = kin.qdot(r, c);
+    }
+  }
+  OpenSim::TimeSeriesTable table(kin.times, states, labels);
+  table.addTableMetaData<std::string>("inDegrees", "no");
+  OpenSim::STOFileAdapter::write(table, statesFile.string());
+}
+
+void process(const IKOutput &output, const std::filesystem::path &setupFile,
+             ParticipantModelCache &models, CoordinateSplineCache &splineCache,
+             AnalysisProgress &progress, const std::string &progressKey) {
+  sync_out.println("---Starting Analysis: ", output.motion.string(),
+                   " Model: ", output.model.string());
+  try {
+    std::unique_ptr<OpenSim::Model> model =
+        models.acquire(output.participant, output.model);
+    SimTK::State &s = model->initSystem();
+
+    OpenSim::AnalyzeTool tool(setupFile.string(), false);
+    CoordinateSplineSettings settings;
+    settings.lowpassCutoffFrequency = tool.getLowpassCutoffFrequency();
+    const CoordinateKinematics kin =
+        splineCache.get(*model, output.motion.string(), settings);
+
+    // AnalyzeTool changes the working directory while it runs: every path
+    // handed to it is absolute
+    const std::string name = output.motion.stem().string();
+    const std::filesystem::path resultDir = output.motion.parent_path();
+    const std::filesystem::path statesFile =
+        resultDir / (name + sep + "states.sto");
+    writeStates(*model, kin, statesFile);
+
+    tool.setName(name);
+    tool.setModel(*model);
+    tool.setCoordinatesFileName("");
+    tool.setStatesFileName(statesFile.string());
+    // Already applied to the cached kinematics
+    tool.setLowpassCutoffFrequency(-1);
+    tool.setInitialTime(kin.times.front());
+    tool.setFinalTime(kin.times.back());
+    tool.setResultsDir(resultDir.string());
+    tool.loadStatesFromFile(s);
+    // Failed runs are not recorded, so a rerun retries them
+    if (tool.run()) {
+      progress.markDone(progressKey);
+    } else {
+      sync_out.println("Analysis failed: ", output.motion.string());
+    }
+  } catch (const std::exception &e) {
+    // Catching standard exceptions
+    sync_out.println("Error in processing: ", e.what());
+  } catch (...) {
+    sync_out.println("Error in processing File: ", output.motion.string());
+  }
+  models.release(output.participant);
+  sync_out.println("-------Finished Analysis: ", output.motion.string());
+}
+
+int main(int argc, char *argv[]) {
+  std::chrono::steady_clock::time_point begin =
+      std::chrono::steady_clock::now();
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " <ik_results_path> <analyze_setup.xml> [--threads <n>]"
+                 " [--spline-cache <directory>]"
+              << std::endl;
+    return 1;
+  }
+
+  const std::filesystem::path resultsPath =
+      std::filesystem::absolute(argv[1]);
+  if (!std::filesystem::is_directory(resultsPath)) {
+    std::cerr << "The provided path is not a valid directory: " << resultsPath
+              << std::endl;
+    return 1;
+  }
+  const std::filesystem::path setupFile = std::filesystem::absolute(argv[2]);
+  if (!std::filesystem::exists(setupFile)) {
+    std::cerr << "The provided setup does not exist: " << setupFile
+              << std::endl;
+    return 1;
+  }
+
+  // Threading
+  const int max_threads = 64;
+  int num_threads = std::thread::hardware_concurrency() > max_threads
+                        ? max_threads
+                        : std::thread::hardware_concurrency();
+  std::filesystem::path splineCachePath =
+      resultsPath / "coordinate_spline_cache";
+  for (int i = 3; i + 1 < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--threads") {
+      num_threads = std::clamp(std::stoi(argv[++i]), 1, max_threads);
+    } else if (arg == "--spline-cache") {
+      splineCachePath = std::filesystem::absolute(argv[++i]);
+    }
+  }
+  BS::thread_pool pool(num_threads);
+  sync_out.println("Thread Pool num threads: ", pool.get_thread_count());
+
+  OpenSim::Object::registerType(OpenSim::AllPairsBodyKinematics());
+  OpenSim::IO::SetDigitsPad(4);
+
+  const std::vector<IKOutput> outputs = discoverIKOutputs(resultsPath);
+  AnalysisProgress progress((resultsPath / progressFileName).string(),
+                            setupFile.string());
+  ParticipantModelCache models;
+  CoordinateSplineCache splineCache(splineCachePath);
+  sync_out.println("IK outputs: ", outputs.size(),
+                   " already analyzed: ", progress.size());
+
+  // Progress is keyed relative to the results directory so it survives moving
+  // the dataset
+  std::vector<std::pair<const IKOutput *, std::string>> pending;
+  for (const IKOutput &output : outputs) {
+    std::string key =
+        std::filesystem::relative(output.motion, resultsPath).string();
+    if (!progress.isDone(key)) {
+      models.expect(output.participant);
+      pending.emplace_back(&output, std::move(key));
+    }
+  }
+  for (const auto &[output, key] : pending) {
+    pool.detach_task(
+        [output, key, &setupFile, &models, &splineCache, &progress] {
+          process(*output, setupFile, models, splineCache, progress, key);
+        });
+  }
+  // Wait for all tasks to finish
+  pool.wait();
+
+  sync_out.println("Analyzed: ", progress.size(), " of ", outputs.size(),
+                   " Models parsed: ", models.parsed(),
+                   " Spline cache: ", splineCache.hits(), " hits, ",
+                   splineCache.misses(), " misses");
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  const double runtime =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+          .count();
+  sync_out.println("Runtime = ", runtime, " [µs]");
+  sync_out.println("Finished Running without Error!");
+  return 0;
+}
@@ -0,0 +1,81 @@
+#ifndef OPENSIM_BOUNDED_QUEUE_H_
+#define OPENSIM_BOUNDED_QUEUE_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  BoundedQueue.h                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+// Fixed-capacity multi-producer/multi-consumer queue used to hand work from
+// one stage of a pipeline to the next. push() blocks while the queue is full
+// so a fast producer cannot run ahead of its consumers by more than
+// `capacity` items. After close(), pop() drains the remaining items and then
+// returns std::nullopt.
+template <typename T> class BoundedQueue {
+public:
+  explicit BoundedQueue(size_t capacity) : _capacity(capacity ? capacity : 1) {}
+
+  // Returns false if the queue was closed before the item could be added.
+  bool push(T item) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _notFull.wait(lock, [this] { return _closed || _items.size() < _capacity; });
+    if (_closed) {
+      return false;
+    }
+    _items.push_back(std::move(item));
+    _notEmpty.notify_one();
+    return true;
+  }
+
+  std::optional<T> pop() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _notEmpty.wait(lock, [this] { return _closed || !_items.empty(); });
+    if (_items.empty()) {
+      return std::nullopt;
+    }
+    T item = std::move(_items.front());
+    _items.pop_front();
+    _notFull.notify_one();
+    return item;
+  }
+
+  void close() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _closed = true;
+    _notEmpty.notify_all();
+    _notFull.notify_all();
+  }
+
+private:
+  const size_t _capacity;
+  std::deque<T> _items;
+  bool _closed = false;
+  std::mutex _mutex;
+  std::condition_variable _notEmpty;
+  std::condition_variable _notFull;
+};
+
+#endif // OPENSIM_BOUNDED_QUEUE_H_
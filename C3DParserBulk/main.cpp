@@ -26,29 +26,115 @@
 #include <OpenSim/Common/STOFileAdapter.h>
 #include <OpenSim/Common/TRCFileAdapter.h>
 
+#include "BoundedQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
 #include <chrono> // for std::chrono functions
+#include <cstring>
 #include <clocale>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <set>
+#include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace fs = std::filesystem;
 
-void processC3DFile(const fs::path &filename, const fs::path &resultPath) {
+// Which tables (and optionally which channels) to extract from each C3D file.
+// By default everything is written, as before.
+struct ExtractionRequest {
+  bool markers = true;
+  bool forces = true;
+  bool analog = true;
+  std::set<std::string> channels; // empty = all channels
+};
+
+// Worker counts of the decode and write stages and the number of decoded
+// files that may wait between them.
+struct PipelineConfig {
+  int decoders = std::max(1, int(std::thread::hardware_concurrency()) / 2);
+  int writers = 2;
+  size_t queue_size = 4;
+};
+
+std::vector<std::string> splitList(const std::string &list) {
+  std::vector<std::string> items;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+// Reduce a table to the requested channels. Returns false if none of the
+// requested channels are in the table, in which case it is not written.
+template <typename ETY>
+bool selectChannels(OpenSim::TimeSeriesTable_<ETY> &table,
+                    const std::set<std::string> &channels) {
+  if (channels.empty()) {
+    return true;
+  }
+  for (const auto &label : table.getColumnLabels()) {
+    if (channels.count(label) == 0) {
+      table.removeColumn(label);
+    }
+  }
+  return table.getNumColumns() > 0;
+}
+
+// A decoded C3D file waiting to be written. Tables that were not requested
+// are left empty.
+struct DecodedC3D {
+  fs::path filename;
+  std::string marker_file;
+  std::string forces_file;
+  std::string analogs_file;
+  std::shared_ptr<OpenSim::TimeSeriesTableVec3> marker_table;
+  std::unique_ptr<OpenSim::TimeSeriesTable> force_table; // flattened
+  std::shared_ptr<OpenSim::TimeSeriesTable> analog_table;
+};
+
+// Busy time accumulated by all workers of one pipeline stage.
+struct StageStats {
+  std::atomic<int64_t> busy_us{0};
+  std::atomic<int> items{0};
+
+  void report(const std::string &name, int workers, int64_t wall_us) const {
+    const double utilization =
+        wall_us > 0 ? double(busy_us) / (double(wall_us) * workers) : 0.0;
+    std::cout << name << ": " << workers << " workers, " << items
+              << " files, busy = " << busy_us << "[µs], utilization = "
+              << 100.0 * utilization << "%" << std::endl;
+  }
+};
+
+int64_t elapsedMicroseconds(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - since)
+      .count();
+}
+
+// Decode stage: read the C3D file and prepare every requested table so the
+// write stage only has to serialize.
+std::optional<DecodedC3D> decodeC3DFile(const fs::path &filename,
+                                        const fs::path &resultPath,
+                                        const ExtractionRequest &request) {
   std::cout << "---Starting Processing: " << filename << std::endl;
   try {
     OpenSim::C3DFileAdapter c3dFileAdapter{};
     auto tables = c3dFileAdapter.read(filename);
 
-    std::shared_ptr<OpenSim::TimeSeriesTableVec3> marker_table =
-        c3dFileAdapter.getMarkersTable(tables);
-    std::shared_ptr<OpenSim::TimeSeriesTableVec3> force_table =
-        c3dFileAdapter.getForcesTable(tables);
-    std::shared_ptr<OpenSim::TimeSeriesTable> analog_table =
-        c3dFileAdapter.getAnalogDataTable(tables);
-
     // Get the last two parent directories
     std::filesystem::path firstParent = filename.parent_path(); // First parent
 
@@ -58,9 +144,6 @@ void processC3DFile(const fs::path &filename, const fs::path &resultPath) {
     std::filesystem::path thirdParent =
         secondParent.parent_path(); // Second parent
 
-    // std::cout << firstParent.filename() << " " << secondParent.filename() <<
-    // " " << thirdParent.filename() << std::endl;
-
     std::filesystem::path baseDir = resultPath / thirdParent.filename() /
                                     "extracted" / firstParent.filename() / "";
 
@@ -73,68 +156,226 @@ void processC3DFile(const fs::path &filename, const fs::path &resultPath) {
       std::cerr << "Error creating directories: " << e.what() << std::endl;
     }
 
-    const std::string marker_file =
+    DecodedC3D decoded;
+    decoded.filename = filename;
+    decoded.marker_file =
         baseDir.string() + filename.stem().string() + "_markers.trc";
-    const std::string forces_file =
+    decoded.forces_file =
         baseDir.string() + filename.stem().string() + "_grfs.sto";
-    const std::string analogs_file =
+    decoded.analogs_file =
         baseDir.string() + filename.stem().string() + "_analog.sto";
 
-    // Write marker locations
-    marker_table->updTableMetaData().setValueForKey("Units", std::string{"mm"});
-    OpenSim::TRCFileAdapter trc_adapter{};
-    trc_adapter.write(*marker_table, marker_file);
-    std::cout << "\tWrote '" << marker_file << std::endl;
-
-    // Write forces and analog
-    OpenSim::STOFileAdapter sto_adapter{};
-    sto_adapter.write((force_table->flatten()), forces_file);
-    std::cout << "\tWrote'" << forces_file << std::endl;
-    sto_adapter.write(*analog_table, analogs_file);
-    std::cout << "\tWrote'" << analogs_file << std::endl;
+    // C3DFileAdapter::read() always decodes every table; only tables that
+    // were asked for are pulled out of its output, reduced to the requested
+    // channels and flattened.
+    if (request.markers) {
+      auto marker_table = c3dFileAdapter.getMarkersTable(tables);
+      if (selectChannels(*marker_table, request.channels)) {
+        marker_table->updTableMetaData().setValueForKey("Units",
+                                                        std::string{"mm"});
+        decoded.marker_table = marker_table;
+      }
+    }
+    if (request.forces) {
+      auto force_table = c3dFileAdapter.getForcesTable(tables);
+      if (selectChannels(*force_table, request.channels)) {
+        decoded.force_table =
+            std::make_unique<OpenSim::TimeSeriesTable>(force_table->flatten());
+      }
+    }
+    if (request.analog) {
+      auto analog_table = c3dFileAdapter.getAnalogDataTable(tables);
+      if (selectChannels(*analog_table, request.channels)) {
+        decoded.analog_table = analog_table;
+      }
+    }
+    return decoded;
   } catch (...) {
     std::cout << "Error in processing C3D File: " << filename << std::endl;
   }
-  std::cout << "---Ending Processing: " << filename << std::endl;
+  return std::nullopt;
 }
 
-void processDirectory(const fs::path &dirPath, const fs::path &resultPath) {
-  std::vector<std::thread> threads;
+// Write stage: the three outputs of one file are written concurrently.
+void writeDecodedC3D(const DecodedC3D &decoded) {
+  try {
+    std::vector<std::future<void>> writes;
+    if (decoded.marker_table) {
+      writes.push_back(std::async(std::launch::async, [&decoded] {
+        OpenSim::TRCFileAdapter trc_adapter{};
+        trc_adapter.write(*decoded.marker_table, decoded.marker_file);
+        std::cout << "\tWrote '" << decoded.marker_file << std::endl;
+      }));
+    }
+    if (decoded.force_table) {
+      writes.push_back(std::async(std::launch::async, [&decoded] {
+        OpenSim::STOFileAdapter sto_adapter{};
+        sto_adapter.write(*decoded.force_table, decoded.forces_file);
+        std::cout << "\tWrote'" << decoded.forces_file << std::endl;
+      }));
+    }
+    if (decoded.analog_table) {
+      writes.push_back(std::async(std::launch::async, [&decoded] {
+        OpenSim::STOFileAdapter sto_adapter{};
+        sto_adapter.write(*decoded.analog_table, decoded.analogs_file);
+        std::cout << "\tWrote'" << decoded.analogs_file << std::endl;
+      }));
+    }
+    // Wait for all writes before rethrowing the first error
+    for (auto &write : writes) {
+      write.wait();
+    }
+    for (auto &write : writes) {
+      write.get();
+    }
+  } catch (...) {
+    std::cout << "Error in writing C3D File: " << decoded.filename
+              << std::endl;
+  }
+  std::cout << "---Ending Processing: " << decoded.filename << std::endl;
+}
+
+void collectC3DFiles(const fs::path &dirPath, std::vector<fs::path> &files) {
   // Iterate through the directory
   for (const auto &entry : fs::directory_iterator(dirPath)) {
     if (entry.is_directory()) {
       // Recursively process subdirectory
-      processDirectory(entry.path(), resultPath);
+      collectC3DFiles(entry.path(), files);
     } else if (entry.is_regular_file()) {
       // Check if the file has a .c3d extension
       if (entry.path().extension() == ".c3d") {
         std::string fullPathStr = entry.path().string();
         auto rawPos = fullPathStr.find("raw_selected");
         if (rawPos != std::string::npos) {
-          // Create a corresponding text file
-          fs::path textFilePath = entry.path();
-          threads.emplace_back(processC3DFile, textFilePath, resultPath);
+          files.push_back(entry.path());
         }
       }
     }
   }
-  // Join all threads
-  for (auto &thread : threads) {
-    if (thread.joinable()) {
-      thread.join();
-    }
+}
+
+// Two-stage pipeline: decoders push decoded tables into a bounded queue and
+// writers drain it, so decoding of the next files overlaps with disk writes.
+void processFiles(const std::vector<fs::path> &files,
+                  const fs::path &resultPath, const ExtractionRequest &request,
+                  const PipelineConfig &config) {
+  BoundedQueue<DecodedC3D> queue(config.queue_size);
+  std::atomic<size_t> next{0};
+  StageStats decodeStats, writeStats;
+  const auto begin = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> decoders, writers;
+  for (int i = 0; i < config.decoders; ++i) {
+    decoders.emplace_back([&] {
+      for (size_t k = next++; k < files.size(); k = next++) {
+        const auto start = std::chrono::steady_clock::now();
+        auto decoded = decodeC3DFile(files[k], resultPath, request);
+        decodeStats.busy_us += elapsedMicroseconds(start);
+        ++decodeStats.items;
+        if (decoded) {
+          queue.push(std::move(*decoded));
+        }
+      }
+    });
+  }
+  for (int i = 0; i < config.writers; ++i) {
+    writers.emplace_back([&] {
+      while (auto decoded = queue.pop()) {
+        const auto start = std::chrono::steady_clock::now();
+        writeDecodedC3D(*decoded);
+        writeStats.busy_us += elapsedMicroseconds(start);
+        ++writeStats.items;
+      }
+    });
+  }
+
+  for (auto &thread : decoders) {
+    thread.join();
+  }
+  queue.close();
+  for (auto &thread : writers) {
+    thread.join();
   }
+
+  const int64_t wall_us = elapsedMicroseconds(begin);
+  decodeStats.report("Decode stage", config.decoders, wall_us);
+  writeStats.report("Write stage", config.writers, wall_us);
+}
+
+void printUsage(const char *program) {
+  std::cerr << "Usage: " << program
+            << " <directory_path> <output_path>"
+               " [--tables markers,forces,analog] [--channels c1,c2,...]"
+               " [--decoders N] [--writers N] [--queue N]\n"
+               "Every C3D file is still decoded in full; --tables and"
+               " --channels only select what is flattened and written."
+            << std::endl;
+}
+
+// Parses a whole argument as a count of at least 1
+bool parseCount(const char *text, int &count) {
+  const char *end = text + std::strlen(text);
+  int value = 0;
+  const auto [ptr, ec] = std::from_chars(text, end, value);
+  if (ec != std::errc() || ptr != end || value < 1) {
+    return false;
+  }
+  count = value;
+  return true;
 }
 
 int main(int argc, char *argv[]) {
   std::chrono::steady_clock::time_point begin =
       std::chrono::steady_clock::now();
-  if (argc < 3) {
-    std::cerr << "Usage: " << argv[0] << " <directory_path> <output_path>"
-              << std::endl;
+  if (argc < 3 || (argc - 3) % 2 != 0) {
+    printUsage(argv[0]);
     return 1;
   }
 
+  ExtractionRequest request;
+  PipelineConfig config;
+  for (int i = 3; i + 1 < argc; i += 2) {
+    const std::string option = argv[i];
+    if (option == "--tables") {
+      request.markers = request.forces = request.analog = false;
+      for (const auto &table : splitList(argv[i + 1])) {
+        if (table == "markers") {
+          request.markers = true;
+        } else if (table == "forces") {
+          request.forces = true;
+        } else if (table == "analog") {
+          request.analog = true;
+        } else {
+          std::cerr << "Unknown table: " << table << std::endl;
+          return 1;
+        }
+      }
+    } else if (option == "--channels") {
+      for (const auto &channel : splitList(argv[i + 1])) {
+        request.channels.insert(channel);
+      }
+    } else if (option == "--decoders" || option == "--writers" ||
+               option == "--queue") {
+      int count = 0;
+      if (!parseCount(argv[i + 1], count)) {
+        std::cerr << "Invalid value for " << option << ": " << argv[i + 1]
+                  << std::endl;
+        printUsage(argv[0]);
+        return 1;
+      }
+      if (option == "--decoders") {
+        config.decoders = count;
+      } else if (option == "--writers") {
+        config.writers = count;
+      } else {
+        config.queue_size = size_t(count);
+      }
+    } else {
+      std::cerr << "Unknown option: " << option << std::endl;
+      return 1;
+    }
+  }
+
   fs::path directoryPath = argv[1];
   if (!fs::exists(directoryPath) || !fs::is_directory(directoryPath)) {
     std::cerr << "The provided path is not a valid directory." << std::endl;
@@ -143,7 +384,9 @@ int main(int argc, char *argv[]) {
 
   fs::path outputPath = argv[2];
 
-  processDirectory(directoryPath, outputPath);
+  std::vector<fs::path> files;
+  collectC3DFiles(directoryPath, files);
+  processFiles(files, outputPath, request, config);
   std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
   std::cout << "Runtime = "
             << std::chrono::duration_cast<std::chrono::microseconds>(end -
@@ -0,0 +1,95 @@
+#ifndef OPENSIM_TIME_GRID_H_
+#define OPENSIM_TIME_GRID_H_
+/* -------------------------------------------------------------------------- *
+ *                           OpenSim:  TimeGrid.h                             *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+template <typename T>
+std::pair<bool, double> isUniform(const std::vector<T> &x) {
+
+  // Initialize step as NaN
+  T step = std::numeric_limits<T>::quiet_NaN();
+  bool tf = false;
+
+  T maxElement = std::max(std::abs(x.front()), std::abs(x.back()));
+  T tol = 4 * std::numeric_limits<T>::epsilon() * maxElement;
+  size_t numSpaces = x.size() - 1;
+  T span = x.back() - x.front();
+  const T mean_step = (std::isfinite(span))
+                          ? span / numSpaces
+                          : (x.back() / numSpaces - x.front() / numSpaces);
+
+  T stepAbs = std::abs(mean_step);
+  if (stepAbs < tol) {
+    tol = (stepAbs < std::numeric_limits<T>::epsilon() * maxElement)
+              ? std::numeric_limits<T>::epsilon() * maxElement
+              : stepAbs;
+  }
+  std::vector<T> results(x.size());
+  std::adjacent_difference(x.begin(), x.end(), results.begin());
+  // First value from adjacent_difference is the first input so it is skipped
+  tf = std::all_of(
+      results.begin() + 1, results.end(),
+      [&mean_step, &tol](T val) { return std::abs(val - mean_step) <= tol; });
+
+  if (!tf && x.size() == 2) {
+    tf = true; // Handle special case for two elements
+  }
+  if (tf) {
+    step = mean_step;
+  }
+
+  return {tf, step};
+}
+
+template <typename T>
+std::vector<T> createVectorLinspace(
+        int length, T start, T end) {
+    std::vector<T> v(length);
+    for (int i = 0; i < length; ++i) {
+        v[i] = start + i * (end - start) / (length - 1);
+    }
+    return v;
+}
+
+template <typename T>
+std::vector<T> uniformTimeSamples(const T offset, const T step_size,
+                                  const int numEl) {
+  std::vector<int> ivec(numEl);
+  std::iota(ivec.begin(), ivec.end(), 0); // ivec will become: [0..99]
+  std::vector<T> output(ivec.size());
+  std::transform(ivec.begin(), ivec.end(), output.begin(),
+                 [step_size, offset](int value) {
+                   return std::fma(value, step_size, offset);
+                 });
+  return output;
+}
+
+#endif // OPENSIM_TIME_GRID_H_
@@ -0,0 +1,127 @@
+#ifndef OPENSIM_UNIFORM_TIME_AXIS_H_
+#define OPENSIM_UNIFORM_TIME_AXIS_H_
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  UniformTimeAxis.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <vector>
+
+// Exact uniform time axis: sample i is at fma(i, step, offset), computed from
+// the index instead of read from (or accumulated into) a stored column, so it
+// never drifts and any time maps to its row in O(1).
+template <typename T> struct UniformTimeAxis {
+  T offset = 0;
+  T step = 0;
+  std::size_t count = 0;
+
+  T operator[](std::size_t i) const { return std::fma(T(i), step, offset); }
+  T front() const { return offset; }
+  T back() const { return (*this)[count - 1]; }
+
+  // Index i of the interval [t_i, t_i+1] containing t, clamped to the axis
+  std::size_t lowerIndex(T t) const {
+    if (count < 2 || !(t > offset)) {
+      return 0;
+    }
+    std::size_t i = std::min(static_cast<std::size_t>((t - offset) / step),
+                             count - 2);
+    // The division can round across a sample, correct by one either way
+    if (i > 0 && (*this)[i] > t) {
+      --i;
+    } else if (i + 2 < count && (*this)[i + 1] <= t) {
+      ++i;
+    }
+    return i;
+  }
+
+  // Linear interpolation of `values` (one per sample) at t, held constant
+  // outside the axis
+  T interpolate(const T *values, T t) const {
+    if (count < 2 || !(t > offset)) {
+      return values[0];
+    }
+    if (t >= back()) {
+      return values[count - 1];
+    }
+    const std::size_t i = lowerIndex(t);
+    const T w = (t - (*this)[i]) / step;
+    return values[i] + w * (values[i + 1] - values[i]);
+  }
+
+  // Stored column for APIs that need one
+  std::vector<T> materialize() const {
+    std::vector<T> times(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      times[i] = (*this)[i];
+    }
+    return times;
+  }
+};
+
+// Single streaming pass over x with the tolerance of isUniform() (4 eps of the
+// largest magnitude, the mean step from the end points) but no
+// adjacent_difference temporary: the largest deviation of any step from the
+// mean is a SIMD max-reduction. Returns the axis if x is uniform.
+template <typename T>
+std::optional<UniformTimeAxis<T>> detectUniformTimeAxis(const T *x,
+                                                        std::size_t n) {
+  if (n < 2) {
+    return std::nullopt;
+  }
+  const T eps = std::numeric_limits<T>::epsilon();
+  const T maxElement = std::max(std::abs(x[0]), std::abs(x[n - 1]));
+  T tol = 4 * eps * maxElement;
+  const std::size_t numSpaces = n - 1;
+  const T span = x[n - 1] - x[0];
+  const T meanStep = std::isfinite(span)
+                         ? span / numSpaces
+                         : (x[n - 1] / numSpaces - x[0] / numSpaces);
+  const T stepAbs = std::abs(meanStep);
+  if (stepAbs < tol) {
+    tol = (stepAbs < eps * maxElement) ? eps * maxElement : stepAbs;
+  }
+
+  T maxDeviation = 0;
+#pragma omp simd reduction(max : maxDeviation)
+  for (std::size_t i = 1; i < n; ++i) {
+    const T deviation = std::abs((x[i] - x[i - 1]) - meanStep);
+    maxDeviation = deviation > maxDeviation ? deviation : maxDeviation;
+  }
+  if (n > 2 && !(maxDeviation <= tol)) {
+    return std::nullopt;
+  }
+  return UniformTimeAxis<T>{x[0], meanStep, n};
+}
+
+template <typename T>
+std::optional<UniformTimeAxis<T>>
+detectUniformTimeAxis(const std::vector<T> &x) {
+  return detectUniformTimeAxis(x.data(), x.size());
+}
+
+#endif // OPENSIM_UNIFORM_TIME_AXIS_H_
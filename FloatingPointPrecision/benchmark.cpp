@@ -0,0 +1,230 @@
+// Time-grid generator benchmark: throughput and max absolute / ULP error of
+// each way of generating a 40 FPS time column (accumulate, multiply, fma,
+// linspace), and of the uniformity checks, for float and double at 10^3 to
+// 10^maxExponent samples. Scalar loops stay scalar (the target is built with
+// -fno-tree-vectorize); the "simd" variants are `#pragma omp simd` loops,
+// which -fopenmp-simd still vectorizes.
+//
+// ./benchmark [results.csv] [maxExponent]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "TimeGrid.h"
+#include "UniformTimeAxis.h"
+
+// 40 FPS Sampling Rate, as in main.cpp
+const long double offsetExact = 10.675L;
+const long double rateExact = 1.0L / 40.0L;
+
+enum class Generator { Add, Multiply, Fma, Linspace };
+
+const char *generatorName(Generator g) {
+  switch (g) {
+  case Generator::Add:
+    return "add";
+  case Generator::Multiply:
+    return "multiply";
+  case Generator::Fma:
+    return "fma";
+  default:
+    return "linspace";
+  }
+}
+
+template <typename T> const char *typeName();
+template <> const char *typeName<float>() { return "float"; }
+template <> const char *typeName<double>() { return "double"; }
+
+template <typename T>
+void generateScalar(Generator g, T offset, T rate, T last, std::vector<T> &x) {
+  const std::size_t n = x.size();
+  switch (g) {
+  case Generator::Add: {
+    T time = offset;
+    x[0] = time;
+    for (std::size_t i = 1; i < n; ++i) {
+      time += rate;
+      x[i] = time;
+    }
+    break;
+  }
+  case Generator::Multiply:
+    for (std::size_t i = 0; i < n; ++i) {
+      x[i] = T(i) * rate + offset;
+    }
+    break;
+  case Generator::Fma:
+    for (std::size_t i = 0; i < n; ++i) {
+      x[i] = std::fma(T(i), rate, offset);
+    }
+    break;
+  case Generator::Linspace:
+    for (std::size_t i = 0; i < n; ++i) {
+      x[i] = offset + T(i) * (last - offset) / T(n - 1);
+    }
+    break;
+  }
+}
+
+// Same arithmetic as generateScalar, vectorized across samples. Accumulation
+// is a loop-carried dependency and has no SIMD variant.
+template <typename T>
+void generateSimd(Generator g, T offset, T rate, T last, std::vector<T> &x) {
+  const std::size_t n = x.size();
+  T *out = x.data();
+  switch (g) {
+  case Generator::Add:
+    generateScalar(g, offset, rate, last, x);
+    break;
+  case Generator::Multiply:
+#pragma omp simd
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = T(i) * rate + offset;
+    }
+    break;
+  case Generator::Fma:
+#pragma omp simd
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = std::fma(T(i), rate, offset);
+    }
+    break;
+  case Generator::Linspace: {
+    const T span = last - offset;
+    const T denominator = T(n - 1);
+#pragma omp simd
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = offset + T(i) * span / denominator;
+    }
+    break;
+  }
+  }
+}
+
+// Largest absolute and ULP error against offset + i / 40 in long double
+template <typename T>
+std::pair<double, double> gridError(const std::vector<T> &x) {
+  double maxAbs = 0;
+  double maxUlp = 0;
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    const long double exact = offsetExact + i * rateExact;
+    const T rounded = static_cast<T>(exact);
+    const long double ulp =
+        std::nextafter(rounded, std::numeric_limits<T>::infinity()) - rounded;
+    const long double error = std::abs(static_cast<long double>(x[i]) - exact);
+    maxAbs = std::max(maxAbs, static_cast<double>(error));
+    maxUlp = std::max(maxUlp, static_cast<double>(error / ulp));
+  }
+  return {maxAbs, maxUlp};
+}
+
+// detectUniformTimeAxis's streaming pass without the SIMD reduction
+template <typename T> bool isUniformStreamingScalar(const std::vector<T> &x) {
+  const std::size_t n = x.size();
+  const T eps = std::numeric_limits<T>::epsilon();
+  const T maxElement = std::max(std::abs(x.front()), std::abs(x.back()));
+  T tol = 4 * eps * maxElement;
+  const T meanStep = (x.back() - x.front()) / (n - 1);
+  const T stepAbs = std::abs(meanStep);
+  if (stepAbs < tol) {
+    tol = (stepAbs < eps * maxElement) ? eps * maxElement : stepAbs;
+  }
+  T maxDeviation = 0;
+  for (std::size_t i = 1; i < n; ++i) {
+    maxDeviation =
+        std::max(maxDeviation, std::abs((x[i] - x[i - 1]) - meanStep));
+  }
+  return n == 2 || maxDeviation <= tol;
+}
+
+// Enough repeats for ~10^7 samples per measurement
+int repeatsFor(std::size_t n) {
+  return static_cast<int>(std::clamp<std::size_t>(10000000 / n, 1, 1000));
+}
+
+template <typename F> double meanMicroseconds(int repeats, F &&f) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < repeats; ++r) {
+    f();
+  }
+  const auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(stop - start).count() /
+         repeats;
+}
+
+void writeRow(std::ostream &out, const char *type, const std::string &kernel,
+              const char *variant, std::size_t n, int repeats, double us,
+              double maxAbs, double maxUlp, const std::string &uniform) {
+  out << type << ',' << kernel << ',' << variant << ',' << n << ',' << repeats
+      << ',' << us << ',' << n / us << ',' << maxAbs << ',' << maxUlp << ','
+      << uniform << '\n';
+}
+
+template <typename T> void benchmark(std::ostream &out, int maxExponent) {
+  const T offset = static_cast<T>(offsetExact);
+  const T rate = static_cast<T>(rateExact);
+  std::size_t n = 1000;
+  for (int exponent = 3; exponent <= maxExponent; ++exponent, n *= 10) {
+    const int repeats = repeatsFor(n);
+    const T last = std::fma(T(n - 1), rate, offset);
+    std::vector<T> x(n);
+    for (Generator g : {Generator::Add, Generator::Multiply, Generator::Fma,
+                        Generator::Linspace}) {
+      double us =
+          meanMicroseconds(repeats, [&] { generateScalar(g, offset, rate, last, x); });
+      auto [maxAbs, maxUlp] = gridError(x);
+      writeRow(out, typeName<T>(), generatorName(g), "scalar", n, repeats, us,
+               maxAbs, maxUlp, "");
+      if (g != Generator::Add) {
+        us = meanMicroseconds(repeats,
+                              [&] { generateSimd(g, offset, rate, last, x); });
+        std::tie(maxAbs, maxUlp) = gridError(x);
+        writeRow(out, typeName<T>(), generatorName(g), "simd", n, repeats, us,
+                 maxAbs, maxUlp, "");
+      }
+    }
+
+    // Uniformity checks on the fma grid (x holds the last linspace grid)
+    generateSimd(Generator::Fma, offset, rate, last, x);
+    bool uniform = false;
+    double us = meanMicroseconds(repeats, [&] { uniform = isUniform(x).first; });
+    writeRow(out, typeName<T>(), "isUniform", "scalar", n, repeats, us, 0, 0,
+             uniform ? "1" : "0");
+    us = meanMicroseconds(repeats,
+                          [&] { uniform = isUniformStreamingScalar(x); });
+    writeRow(out, typeName<T>(), "isUniform_streaming", "scalar", n, repeats,
+             us, 0, 0, uniform ? "1" : "0");
+    us = meanMicroseconds(
+        repeats, [&] { uniform = detectUniformTimeAxis(x).has_value(); });
+    writeRow(out, typeName<T>(), "isUniform_streaming", "simd", n, repeats, us,
+             0, 0, uniform ? "1" : "0");
+    std::cerr << typeName<T>() << " 10^" << exponent << " done" << std::endl;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  const std::string resultsFile =
+      argc > 1 ? argv[1] : "time_grid_benchmark.csv";
+  const int maxExponent = argc > 2 ? std::stoi(argv[2]) : 8;
+
+  std::ofstream out(resultsFile);
+  if (!out) {
+    std::cerr << "Cannot write " << resultsFile << std::endl;
+    return 1;
+  }
+  out.precision(17);
+  out << "type,kernel,variant,samples,repeats,time_us,samples_per_us,"
+         "max_abs_error,max_ulp_error,uniform\n";
+  benchmark<float>(out, maxExponent);
+  benchmark<double>(out, maxExponent);
+  std::cout << "Results written to " << resultsFile << std::endl;
+  std::cout << "Finished Running without Error!" << std::endl;
+  return 0;
+}
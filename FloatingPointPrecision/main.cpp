@@ -9,65 +9,23 @@
 #include <string>
 #include <vector>
 
+#include "TimeGrid.h"
+#include "UniformTimeAxis.h"
+
+// Linear interpolation on a stored time column (binary search per query)
 template <typename T>
-std::pair<bool, double> isUniform(const std::vector<T> &x) {
-
-  // Initialize step as NaN
-  T step = std::numeric_limits<T>::quiet_NaN();
-  bool tf = false;
-
-  T maxElement = std::max(std::abs(x.front()), std::abs(x.back()));
-  T tol = 4 * std::numeric_limits<T>::epsilon() * maxElement;
-  size_t numSpaces = x.size() - 1;
-  T span = x.back() - x.front();
-  const T mean_step = (std::isfinite(span))
-                          ? span / numSpaces
-                          : (x.back() / numSpaces - x.front() / numSpaces);
-
-  T stepAbs = std::abs(mean_step);
-  if (stepAbs < tol) {
-    tol = (stepAbs < std::numeric_limits<T>::epsilon() * maxElement)
-              ? std::numeric_limits<T>::epsilon() * maxElement
-              : stepAbs;
-  }
-  std::vector<T> results(x.size());
-  std::adjacent_difference(x.begin(), x.end(), results.begin());
-  // First value from adjacent_difference is the first input so it is skipped
-  tf = std::all_of(
-      results.begin() + 1, results.end(),
-      [&mean_step, &tol](T val) { return std::abs(val - mean_step) <= tol; });
-
-  if (!tf && x.size() == 2) {
-    tf = true; // Handle special case for two elements
+T interpolateColumn(const std::vector<T> &times, const std::vector<T> &values,
+                    T t) {
+  if (!(t > times.front())) {
+    return values.front();
   }
-  if (tf) {
-    step = mean_step;
+  if (t >= times.back()) {
+    return values.back();
   }
-
-  return {tf, step};
-}
-
-template <typename T>
-std::vector<T> createVectorLinspace(
-        int length, T start, T end) {
-    std::vector<T> v(length);
-    for (int i = 0; i < length; ++i) {
-        v[i] = start + i * (end - start) / (length - 1);
-    }
-    return v;
-}
-
-template <typename T>
-std::vector<T> uniformTimeSamples(const T offset, const T step_size,
-                                  const int numEl) {
-  std::vector<int> ivec(numEl);
-  std::iota(ivec.begin(), ivec.end(), 0); // ivec will become: [0..99]
-  std::vector<T> output(ivec.size());
-  std::transform(ivec.begin(), ivec.end(), output.begin(),
-                 [step_size, offset](int value) {
-                   return std::fma(value, step_size, offset);
-                 });
-  return output;
+  const std::size_t i =
+      std::upper_bound(times.begin(), times.end(), t) - times.begin() - 1;
+  const T w = (t - times[i]) / (times[i + 1] - times[i]);
+  return values[i] + w * (values[i + 1] - values[i]);
 }
 
 int main() {
@@ -113,7 +71,8 @@ int main() {
 
   std::vector<double> decimalValues4 = createVectorLinspace(numEl,offset,last_num);
 
-  for (int i = startVal; i < numEl; ++i) {
+  // Every 10000th sample; benchmark.cpp measures all generators in full
+  for (int i = startVal; i < numEl; i += 10000) {
     std::cout << std::fixed << std::setprecision(32)
               << "Add: " << decimalValues[i]
               << " Multiply: " << decimalValues2[i]
@@ -139,6 +98,75 @@ int main() {
   std::cout << "FMA Uniformly Spaced: " << tf4 << " Step: " << step4
             << std::endl;
 
+  // Detection at load: one streaming pass must agree with isUniform()
+  bool axisMatches = true;
+  for (const std::vector<double> *x :
+       {&vec2, &decimalValues, &decimalValues2, &decimalValues3,
+        &decimalValues4}) {
+    const auto axis = detectUniformTimeAxis(*x);
+    axisMatches = axisMatches && (axis.has_value() == isUniform(*x).first);
+  }
+  std::cout << "detectUniformTimeAxis "
+            << (axisMatches ? "matches" : "DIFFERS from") << " isUniform"
+            << std::endl;
+
+  const int repeats = 100;
+  auto timeUs = [&](auto &&f) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i) {
+      f();
+    }
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(stop - start)
+               .count() /
+           double(repeats);
+  };
+  int uniformRuns = 0;
+  const double isUniformTime =
+      timeUs([&] { uniformRuns += isUniform(decimalValues3).first; });
+  const double detectTime = timeUs(
+      [&] { uniformRuns += detectUniformTimeAxis(decimalValues3).has_value(); });
+  std::cout << std::defaultfloat << std::setprecision(6)
+            << "isUniform = " << isUniformTime
+            << "[µs], detectUniformTimeAxis = " << detectTime << "[µs] ("
+            << uniformRuns << " uniform results)" << std::endl;
+
+  // Interpolation: O(1) index on the axis vs binary search on the column
+  const UniformTimeAxis<double> axis =
+      detectUniformTimeAxis(decimalValues3).value();
+  std::vector<double> signal(numEl);
+  for (int i = 0; i < numEl; ++i) {
+    signal[i] = std::sin(0.01 * i);
+  }
+  const int numQueries = 100000;
+  std::vector<double> queries(numQueries);
+  for (int i = 0; i < numQueries; ++i) {
+    queries[i] = offset + (i * 7919 % numQueries) * (axis.back() - offset) /
+                              numQueries;
+  }
+  std::vector<double> axisValues(numQueries), columnValues(numQueries);
+  const double axisTime = timeUs([&] {
+    for (int i = 0; i < numQueries; ++i) {
+      axisValues[i] = axis.interpolate(signal.data(), queries[i]);
+    }
+  });
+  const double columnTime = timeUs([&] {
+    for (int i = 0; i < numQueries; ++i) {
+      columnValues[i] =
+          interpolateColumn(decimalValues3, signal, queries[i]);
+    }
+  });
+  double interpolationError = 0;
+  for (int i = 0; i < numQueries; ++i) {
+    interpolationError = std::max(
+        interpolationError, std::abs(axisValues[i] - columnValues[i]));
+  }
+  std::cout << "Interpolation (" << numQueries
+            << " queries): UniformTimeAxis = " << axisTime
+            << "[µs], stored column = " << columnTime
+            << "[µs], max difference = " << interpolationError << std::endl;
+  const bool interpolationMatches = interpolationError < 1e-9;
+
   const double err1 = std::abs(last_num - decimalValues[numEl - 1]);
   const double err2 = std::abs(last_num - decimalValues2[numEl - 1]);
   const double err3 = std::abs(last_num - decimalValues3[numEl - 1]);
@@ -155,6 +183,9 @@ int main() {
                                                                      begin)
                    .count()
             << "[µs]" << std::endl;
+  if (!axisMatches || !interpolationMatches) {
+    return 1;
+  }
   std::cout << "Finished Running without Error!" << std::endl;
   return 0;
 }
@@ -0,0 +1,176 @@
+#ifndef OPENSIM_IMU_PLACEMENT_DELTA_H_
+#define OPENSIM_IMU_PLACEMENT_DELTA_H_
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  IMUPlacementDelta.h                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Simulation/Model/Geometry.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/PhysicalOffsetFrame.h>
+
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// What IMUPlacer changes in a model: the *_imu offset frames it adds to (or
+// updates on) the bodies. Written instead of the whole calibrated .osim, the
+// delta is a few hundred bytes, and applying it to a cached base model avoids
+// re-parsing a full model per trial.
+//
+// File format (tab separated, one frame per line):
+//   base_model <path to the uncalibrated .osim>
+//   frame <name> <parent body path> <tx ty tz> <ox oy oz>
+// translation and orientation are the PhysicalOffsetFrame properties (body
+// fixed XYZ), written with max_digits10 so they round-trip exactly.
+struct IMUFrameDelta {
+  std::string name;
+  std::string parent;
+  SimTK::Vec3 translation;
+  SimTK::Vec3 orientation;
+};
+
+struct IMUPlacementDelta {
+  std::string baseModel;
+  std::vector<IMUFrameDelta> frames;
+};
+
+// Extension of delta files next to the calibrated .osim they replace
+const std::string imuDeltaExtension = ".imudelta";
+
+// The *_imu frames of a calibrated model
+inline IMUPlacementDelta extractIMUDelta(const OpenSim::Model &calibrated,
+                                         const std::string &baseModel) {
+  IMUPlacementDelta delta;
+  delta.baseModel = baseModel;
+  for (const auto &frame :
+       calibrated.getComponentList<OpenSim::PhysicalOffsetFrame>()) {
+    const std::string &name = frame.getName();
+    if (name.size() < 4 || name.compare(name.size() - 4, 4, "_imu") != 0) {
+      continue;
+    }
+    delta.frames.push_back({name,
+                            frame.getParentFrame().getAbsolutePathString(),
+                            frame.get_translation(), frame.get_orientation()});
+  }
+  return delta;
+}
+
+inline void writeIMUDelta(const IMUPlacementDelta &delta,
+                          const std::string &fileName) {
+  std::ofstream file(fileName);
+  OPENSIM_THROW_IF(!file, OpenSim::Exception, "Could not write " + fileName);
+  file.precision(std::numeric_limits<double>::max_digits10);
+  file << "base_model\t" << delta.baseModel << '\n';
+  for (const IMUFrameDelta &f : delta.frames) {
+    file << "frame\t" << f.name << '\t' << f.parent << '\t'
+         << f.translation[0] << ' ' << f.translation[1] << ' '
+         << f.translation[2] << '\t' << f.orientation[0] << ' '
+         << f.orientation[1] << ' ' << f.orientation[2] << '\n';
+  }
+}
+
+inline IMUPlacementDelta readIMUDelta(const std::string &fileName) {
+  std::ifstream file(fileName);
+  OPENSIM_THROW_IF(!file, OpenSim::Exception, "Could not read " + fileName);
+  IMUPlacementDelta delta;
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream ss(line);
+    std::string key;
+    std::getline(ss, key, '\t');
+    if (key == "base_model") {
+      std::getline(ss, delta.baseModel);
+    } else if (key == "frame") {
+      IMUFrameDelta f;
+      std::getline(ss, f.name, '\t');
+      std::getline(ss, f.parent, '\t');
+      ss >> f.translation[0] >> f.translation[1] >> f.translation[2] >>
+          f.orientation[0] >> f.orientation[1] >> f.orientation[2];
+      OPENSIM_THROW_IF(ss.fail(), OpenSim::Exception,
+                       "Malformed frame line in " + fileName + ": " + line);
+      delta.frames.push_back(f);
+    }
+  }
+  OPENSIM_THROW_IF(delta.baseModel.empty(), OpenSim::Exception,
+                   "No base_model in " + fileName);
+  return delta;
+}
+
+// Adds or updates the delta's frames on `model` the way IMUPlacer does
+// (frames are subcomponents of their body, with a small brick attached).
+// Call finalizeConnections()/initSystem() afterwards.
+inline void applyIMUDelta(OpenSim::Model &model,
+                          const IMUPlacementDelta &delta) {
+  for (const IMUFrameDelta &f : delta.frames) {
+    auto &parent = model.updComponent<OpenSim::PhysicalFrame>(f.parent);
+    const auto *existing =
+        parent.findComponent<OpenSim::PhysicalOffsetFrame>(f.name);
+    if (existing) {
+      auto *frame = const_cast<OpenSim::PhysicalOffsetFrame *>(existing);
+      frame->set_translation(f.translation);
+      frame->set_orientation(f.orientation);
+      continue;
+    }
+    auto *frame = new OpenSim::PhysicalOffsetFrame(f.name, parent,
+                                                   SimTK::Transform());
+    frame->set_translation(f.translation);
+    frame->set_orientation(f.orientation);
+    auto *brick = new OpenSim::Brick(SimTK::Vec3(0.02, 0.01, 0.005));
+    brick->setColor(SimTK::Orange);
+    frame->attachGeometry(brick);
+    parent.addComponent(frame);
+  }
+  model.finalizeFromProperties();
+}
+
+// Base models parsed once and shared read-only; each calibrated model is a
+// clone with a delta applied.
+class IMUDeltaModelCache {
+public:
+  std::unique_ptr<OpenSim::Model> load(const std::string &deltaFile) {
+    const IMUPlacementDelta delta = readIMUDelta(deltaFile);
+    std::unique_ptr<OpenSim::Model> model;
+    {
+      // Parsing and copying read the cached model; serialize both
+      std::lock_guard<std::mutex> lock(_mutex);
+      std::unique_ptr<OpenSim::Model> &base = _models[delta.baseModel];
+      if (!base) {
+        base = std::make_unique<OpenSim::Model>(delta.baseModel);
+      }
+      model.reset(base->clone());
+    }
+    applyIMUDelta(*model, delta);
+    return model;
+  }
+
+private:
+  std::map<std::string, std::unique_ptr<OpenSim::Model>> _models;
+  std::mutex _mutex;
+};
+
+#endif // OPENSIM_IMU_PLACEMENT_DELTA_H_
@@ -0,0 +1,201 @@
+#ifndef OPENSIM_ORIENTATION_SENSOR_PRUNING_H_
+#define OPENSIM_ORIENTATION_SENSOR_PRUNING_H_
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  OrientationSensorPruning.h                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Common/Exception.h>
+#include <OpenSim/Simulation/OrientationsReference.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A sensor with weight 0 in an OrientationWeightSet adds nothing to the IK
+// cost, but IMUInverseKinematicsTool still reads and rotates its column and
+// evaluates its orientation goal every frame. Dropping those columns from the
+// orientations file before the tool sees it removes them from the reference
+// data and the goal entirely; the solution is unchanged.
+
+// Sensors the weight set switches off. Sensors it does not list keep the
+// OrientationsReference default weight of 1.
+inline std::set<std::string>
+zeroWeightSensors(const OpenSim::OrientationWeightSet &weights) {
+  std::set<std::string> sensors;
+  for (int i = 0; i < weights.getSize(); ++i) {
+    if (weights.get(i).getWeight() == 0) {
+      sensors.insert(weights.get(i).getName());
+    }
+  }
+  return sensors;
+}
+
+struct PrunedOrientations {
+  std::size_t activeSensors = 0;
+  std::size_t droppedSensors = 0;
+  std::size_t rows = 0;
+};
+
+// Copies an orientations .sto to `prunedFile` without the `dropped` sensor
+// columns. Works on the text directly: each quaternion is one tab separated
+// field, so nothing is parsed or re-formatted and values round-trip exactly.
+inline PrunedOrientations
+pruneOrientationsFile(const std::string &orientationsFile,
+                      const std::set<std::string> &dropped,
+                      const std::string &prunedFile) {
+  std::ifstream in(orientationsFile);
+  OPENSIM_THROW_IF(!in, OpenSim::Exception,
+                   "Could not read " + orientationsFile);
+  std::ofstream out(prunedFile);
+  OPENSIM_THROW_IF(!out, OpenSim::Exception, "Could not write " + prunedFile);
+
+  PrunedOrientations pruned;
+  std::string line;
+  // Header
+  while (std::getline(in, line)) {
+    out << line << '\n';
+    if (line.rfind("endheader", 0) == 0) {
+      break;
+    }
+  }
+
+  auto split = [](std::string_view row, std::vector<std::string_view> &fields) {
+    fields.clear();
+    std::size_t start = 0;
+    while (true) {
+      const std::size_t tab = row.find('\t', start);
+      fields.push_back(row.substr(start, tab - start));
+      if (tab == std::string_view::npos) {
+        break;
+      }
+      start = tab + 1;
+    }
+  };
+  auto writeKept = [&](const std::vector<std::string_view> &fields,
+                       const std::vector<std::size_t> &keep) {
+    for (std::size_t k = 0; k < keep.size(); ++k) {
+      if (k > 0) {
+        out << '\t';
+      }
+      out << fields[keep[k]];
+    }
+    out << '\n';
+  };
+
+  // Column labels; time is always kept
+  std::vector<std::string_view> fields;
+  std::vector<std::size_t> keep;
+  OPENSIM_THROW_IF(!std::getline(in, line), OpenSim::Exception,
+                   "No column labels in " + orientationsFile);
+  split(line, fields);
+  for (std::size_t i = 0; i < fields.size(); ++i) {
+    if (i > 0 && dropped.count(std::string(fields[i]))) {
+      ++pruned.droppedSensors;
+    } else {
+      keep.push_back(i);
+    }
+  }
+  pruned.activeSensors = keep.size() - 1;
+  writeKept(fields, keep);
+
+  while (std::getline(in, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    split(line, fields);
+    OPENSIM_THROW_IF(fields.size() <= keep.back(), OpenSim::Exception,
+                     "Row " + std::to_string(pruned.rows) + " of " +
+                         orientationsFile + " has too few columns");
+    writeKept(fields, keep);
+    ++pruned.rows;
+  }
+  return pruned;
+}
+
+// Pruned copies of orientations files, written once per (file, dropped
+// sensors) into `directory` and shared by every weight set that drops the same
+// sensors of the same trial. The directory is removed with the cache, so it
+// must outlive the IK runs reading from it.
+class PrunedOrientationsCache {
+public:
+  explicit PrunedOrientationsCache(std::filesystem::path directory)
+      : _directory(std::move(directory)) {
+    std::filesystem::create_directories(_directory);
+  }
+  ~PrunedOrientationsCache() {
+    std::error_code ec;
+    std::filesystem::remove_all(_directory, ec);
+  }
+  PrunedOrientationsCache(const PrunedOrientationsCache &) = delete;
+  PrunedOrientationsCache &operator=(const PrunedOrientationsCache &) = delete;
+
+  // Path of the pruned copy of `orientationsFile`; the first caller writes
+  // it, concurrent callers for the same key wait for that write.
+  std::string get(const std::string &orientationsFile,
+                  const std::set<std::string> &dropped,
+                  PrunedOrientations &pruned) {
+    std::string key = orientationsFile;
+    for (const std::string &sensor : dropped) {
+      key += '\t' + sensor;
+    }
+    Entry *entry = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      std::unique_ptr<Entry> &slot = _entries[key];
+      if (!slot) {
+        slot = std::make_unique<Entry>();
+        slot->path = (_directory / ("pruned_" + std::to_string(_entries.size()) +
+                                    ".sto"))
+                         .string();
+      }
+      entry = slot.get();
+    }
+    // A throwing write leaves the flag unset, so the next caller retries
+    std::call_once(entry->once, [&] {
+      entry->pruned =
+          pruneOrientationsFile(orientationsFile, dropped, entry->path);
+    });
+    pruned = entry->pruned;
+    return entry->path;
+  }
+
+private:
+  struct Entry {
+    std::once_flag once;
+    std::string path;
+    PrunedOrientations pruned;
+  };
+
+  std::filesystem::path _directory;
+  std::mutex _mutex;
+  std::map<std::string, std::unique_ptr<Entry>> _entries;
+};
+
+#endif // OPENSIM_ORIENTATION_SENSOR_PRUNING_H_
@@ -7,6 +7,11 @@
 
 // Thread Pool
 #include "BS_thread_pool.hpp" // BS::synced_stream, BS::thread_pool
+#include "IKSeedCache.h"
+#include "IMUPlacementDelta.h"
+#include "ModelPreflight.h"
+#include "OrientationSensorPruning.h"
+#include "ParticipantStore.h"
 
 #include <algorithm> // For std::find_if
 #include <chrono>    // for std::chrono functions
@@ -18,6 +23,7 @@
 #include <memory>
 #include <optional>
 #include <regex>
+#include <set>
 #include <string>
 #include <thread>
 #include <vector>
@@ -60,15 +66,12 @@ const std::vector<std::string> baseModels = {
 //     "08", "09", "12", "17", "19", "21", "24",
 //     "28", "31", "34", "36", "38", "40", "41"};
 
-// All trials - excluded no IMUs collected - some subjects (11, 14, 37, 49) do not have keypoint and IMU data.
-const std::vector<std::string> includedParticipants = {
-    "01", "02", "03", "04", "05", "06", "07", "08", "09", 
-    "10", "12", "13", "15", "16", "17", "18", 
-    "19", "20", "21", "22", "23", "24", "25", "26", "27", 
-    "28", "29", "30", "31", "32", "33", "34", "35", "36", 
-    "38", "39", "40", "41", "42", "43", "44", "45", 
-    "46", "47", "48", "50", "51"
-};
+// All trials - invalid trials are dropped by the ParticipantStore; subjects
+// without IMU data have no orientation files to collect
+const std::vector<std::string> includedParticipants = {};
+const std::string preflightReportFile = "model_preflight.csv";
+const std::string ikSeedCacheFile = "ik_seed_cache.tsv";
+const std::string fileNameParticipants = "info_participants.csv";
 
 const std::string imu_removed_suffix = "";
 const std::string outputBasePrefix = "kg";
@@ -76,8 +79,12 @@ const std::string imuSuffix = "and_IMUs";
 
 const std::string sep = "_";
 
+// Base models of IMUPlacerBulk --delta outputs, parsed once for all trials
+IMUDeltaModelCache deltaModelCache;
+
 void process(const std::filesystem::path &file,
-             const std::filesystem::path &resultDir, const ConfigType &c) {
+             const std::filesystem::path &resultDir, const ConfigType &c,
+             IKSeedCache &seeds, PrunedOrientationsCache &prunedCache) {
   sync_out.println("---Starting IK Processing: ", file.string());
   try {
     const OpenSim::OrientationWeightSet weightSet = c.first;
@@ -97,6 +104,38 @@ void process(const std::filesystem::path &file,
         resultDir / (outputFilePrefix + sep + outputSuffix + ".mot");
 
     if (std::filesystem::exists(modelSourcePath)) {
+      // A placement delta is applied onto the cached base model in memory
+      std::unique_ptr<OpenSim::Model> model;
+      if (modelSourcePath.extension() == imuDeltaExtension) {
+        model = deltaModelCache.load(modelSourcePath.string());
+      } else {
+        model = std::make_unique<OpenSim::Model>(modelSourcePath.string());
+      }
+
+      // Start the first frame from the pose an earlier run converged to. The
+      // weight set is part of the model key since it changes the solution.
+      const std::string participant =
+          file.parent_path().parent_path().filename().string();
+      const std::string trial =
+          ParticipantStore::trialOf(file.stem().string());
+      const std::optional<IKSeed> seed =
+          seeds.find(participant, trial, outputFilePrefix);
+      if (seed) {
+        IKSeedCache::applySeed(*model, *seed);
+      }
+      sync_out.println("First frame starts from ",
+                       seed ? "cached seed" : "default pose");
+
+      // Zero-weight sensors are dropped from the orientations read by IK
+      std::string orientationsFile = file.string();
+      const std::set<std::string> dropped = zeroWeightSensors(weightSet);
+      if (!dropped.empty()) {
+        PrunedOrientations pruned;
+        orientationsFile = prunedCache.get(orientationsFile, dropped, pruned);
+        sync_out.println("Active sensors: ", pruned.activeSensors,
+                         " dropped (weight 0): ", pruned.droppedSensors);
+      }
+
       OpenSim::IMUInverseKinematicsTool imuIk;
       imuIk.setName(outputFilePrefix);
 
@@ -110,13 +149,24 @@ void process(const std::filesystem::path &file,
       // This is the rotation for the kuopio gait dataset
       const SimTK::Vec3 rotations(-SimTK::Pi / 2, 0, 0);
       imuIk.set_sensor_to_opensim_rotations(rotations);
-      imuIk.set_model_file(modelSourcePath.string());
-      imuIk.set_orientations_file(file.string());
+      if (modelSourcePath.extension() != imuDeltaExtension) {
+        imuIk.set_model_file(modelSourcePath.string());
+      }
+      imuIk.setModel(*model);
+      imuIk.set_orientations_file(orientationsFile);
       imuIk.set_results_directory(resultDir);
       imuIk.set_output_motion_file(outputMotionFile.string());
       imuIk.set_orientation_weights(weightSet);
       bool visualizeResults = false;
       imuIk.run(visualizeResults);
+      if (!seed) {
+        seeds.store(participant, trial, outputFilePrefix,
+                    IKSeedCache::firstFramePose(outputMotionFile.string(),
+                                                *model));
+      }
+      // The pruned copy is temporary; the original file with the weight set
+      // re-runs to the same solution
+      imuIk.set_orientations_file(file.string());
       imuIk.print((resultDir / (outputFilePrefix + sep + outputSuffix + ".xml"))
                       .string());
     } else {
@@ -149,10 +199,14 @@ void collectFiles(const std::filesystem::path &directory,
   }
 }
 
-// Function to filter files based on specific criteria
-void filterFiles(const std::vector<std::filesystem::path> &allFiles,
-                 std::vector<std::filesystem::path> &filteredFiles,
-                 const std::vector<std::string> &includedParticipants) {
+// Function to filter files based on specific criteria. An empty
+// includedParticipants selects everyone; files the participant store rules
+// out (unknown participant, invalid trial) are dropped and counted.
+std::size_t filterFiles(const std::vector<std::filesystem::path> &allFiles,
+                        std::vector<std::filesystem::path> &filteredFiles,
+                        const ParticipantStore &participants,
+                        const std::vector<std::string> &includedParticipants) {
+  std::size_t skipped = 0;
   for (const auto &path : allFiles) {
     std::string filename = path.stem().string();
 
@@ -165,17 +219,23 @@ void filterFiles(const std::vector<std::filesystem::path> &allFiles,
     // Check if the participant ID is in the included list
     const auto it = std::find(includedParticipants.begin(),
                               includedParticipants.end(), participantId);
-    const bool participantIncluded = it != includedParticipants.end();
+    const bool participantIncluded =
+        includedParticipants.empty() || it != includedParticipants.end();
 
     // Check the file extension and naming conditions
     if (path.extension() == ".sto" &&
         (filename.rfind("data_l_", 0) == 0 ||
          filename.rfind("data_r_", 0) == 0) &&
         filename.ends_with("_orientations") && participantIncluded) {
+      if (!participants.isRunnable(participantId, filename)) {
+        ++skipped;
+        continue;
+      }
       // Add the file to the filtered vector if all conditions are met
       filteredFiles.push_back(path);
     }
   }
+  return skipped;
 }
 
 // Function to create the required directory structure
@@ -213,13 +273,14 @@ std::optional<std::filesystem::path>
 findFirstFile(const std::filesystem::path &directory,
               const std::string &modelSearchString,
               const std::string &imuRemovedSearchString,
-              const std::string &trialSearchString) {
+              const std::string &trialSearchString,
+              const std::string &extension = ".osim") {
   for (const auto &entry : std::filesystem::directory_iterator(directory)) {
     if (entry.is_regular_file()) {
       const auto &path = entry.path();
       const auto &filename = path.filename().string();
 
-      if (path.extension() == ".osim" &&
+      if (path.extension() == extension &&
           // file.string().find(modelSearchString) != std::string::npos &&
           path.string().find(modelSearchString) != std::string::npos &&
           path.string().find(imuRemovedSearchString) != std::string::npos &&
@@ -283,8 +344,12 @@ int main(int argc, char *argv[]) {
   collectFiles(directoryPath, allFiles);
 
   // Filter the collected files based on the criteria
+  const ParticipantStore participants(fileNameParticipants);
   std::vector<std::filesystem::path> filteredFiles;
-  filterFiles(allFiles, filteredFiles, includedParticipants);
+  const std::size_t skipped =
+      filterFiles(allFiles, filteredFiles, participants, includedParticipants);
+  sync_out.println("Trials: ", filteredFiles.size(),
+                   " skipped (invalid): ", skipped);
 
   // Create directories for each filtered file
   for (const auto &file : filteredFiles) {
@@ -306,6 +371,15 @@ int main(int argc, char *argv[]) {
                                  });
                 });
 
+  // Models that would throw inside Simbody are rejected before scheduling
+  ModelPreflightCache preflight;
+  std::size_t rejectedTasks = 0;
+  IKSeedCache seedCache((outputPath / ikSeedCacheFile).string());
+  sync_out.println("IK seeds cached: ", seedCache.size());
+  // Orientations without zero-weight sensors, written once per trial and
+  // dropped-sensor set, removed when all tasks are done
+  PrunedOrientationsCache prunedCache(outputPath / "pruned_orientations");
+
   // Run IK on all permutations
   for (const auto &file : filteredFiles) {
     for (const auto &c : config) {
@@ -320,22 +394,54 @@ int main(int argc, char *argv[]) {
       if (match) {
         const std::string trial = match.value()[0];
         std::cout << "Full match: " << trial << " result dir: " << resultDir << std::endl;
-        const auto result =
-            findFirstFile(resultDir, fileNameBaseModel.stem(),
-                          imu_removed_suffix, trial);
+        // Prefer the IMU placement delta over a full calibrated model
+        auto result = findFirstFile(resultDir, fileNameBaseModel.stem(),
+                                    imu_removed_suffix, trial,
+                                    imuDeltaExtension);
+        if (!result) {
+          result = findFirstFile(resultDir, fileNameBaseModel.stem(),
+                                 imu_removed_suffix, trial);
+        }
         if (result) {
           const std::string modelPath = *result;
           std::cout << "Model path: " << modelPath << std::endl;
+          // A placement delta is checked through its base model
+          std::string preflightPath = modelPath;
+          if (result->extension() == imuDeltaExtension) {
+            try {
+              preflightPath = readIMUDelta(modelPath).baseModel;
+            } catch (const std::exception &e) {
+              sync_out.println("Error reading delta: ", e.what());
+              continue;
+            }
+          }
+          if (!preflight.check(preflightPath).empty()) {
+            sync_out.println("Model rejected by preflight: ", preflightPath,
+                             " File: ", file.stem().string());
+            ++rejectedTasks;
+            continue;
+          }
           const ConfigType newConfig = {c.first, modelPath};
-          pool.detach_task([file, resultDir, newConfig] {
-            process(file, resultDir, newConfig);
-          });
+          pool.detach_task(
+              [file, resultDir, newConfig, &seedCache, &prunedCache] {
+                process(file, resultDir, newConfig, seedCache, prunedCache);
+              });
         }
       }
     }
   }
   // Wait for all tasks to finish
   pool.wait();
+  seedCache.save();
+
+  const std::vector<PreflightIssue> preflightIssues = preflight.issues();
+  if (!preflightIssues.empty()) {
+    const std::filesystem::path reportFile = outputPath / preflightReportFile;
+    std::ofstream report(reportFile);
+    writePreflightReport(report, preflightIssues);
+    sync_out.println("Tasks rejected by preflight: ", rejectedTasks,
+                     " Report: ", reportFile);
+  }
 
   std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
   const double runtime =
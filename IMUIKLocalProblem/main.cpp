@@ -29,6 +29,9 @@
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Tools/IMUInverseKinematicsTool.h>
 
+#include "CalibrationWindow.h"
+#include "OrientationWindowReader.h"
+
 #include <string>
 #include <iostream>
 #include <clocale>
@@ -66,6 +69,43 @@ int main()
     facingX.setName("calibrated_FacingX");
     facingX.finalizeFromProperties();
 
+    // Calibration I/O: IMUPlacer parses the whole standing trial, the window
+    // reader stops after the calibration row
+    {
+        const std::string calibrationFile = placerX.get_orientation_file_for_calibration();
+        const int repeats = 20;
+        auto timeRead = [&](auto&& read) {
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < repeats; ++i) {
+                read();
+            }
+            const auto stop = std::chrono::steady_clock::now();
+            return std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count() / repeats;
+        };
+        const auto fullTime = timeRead([&] {
+            TimeSeriesTable_<SimTK::Quaternion> table(calibrationFile);
+        });
+        const auto windowTime = timeRead([&] {
+            readCalibrationWindow(calibrationFile, placerX.get_sensor_to_opensim_rotations());
+        });
+        std::cout << "Calibration read: full trial = " << fullTime
+                  << "[µs], window = " << windowTime << "[µs]" << std::endl;
+
+        // The placement from the window must match the full-trial placement
+        const std::string windowFile = "calibration_window_Facing_X.sto";
+        writeCalibrationWindow(calibrationFile, placerX.get_sensor_to_opensim_rotations(), windowFile);
+        IMUPlacer placerWindowX("imuPlacerFaceX.xml");
+        placeWithWindow(placerWindowX, windowFile);
+        const double difference =
+                maxImuOffsetDifference(facingX, placerWindowX.getCalibratedModel());
+        std::cout << "Max IMU offset difference full vs window = " << difference
+                  << std::endl;
+        if (difference > 1e-9) {
+            std::cout << "Window calibration DIFFERS" << std::endl;
+            return 1;
+        }
+    }
+
     IMUInverseKinematicsTool ik_hjc("setup_IMUInverseKinematics_HJC_trial.xml");
     ik_hjc.setModel(facingX);
     ik_hjc.set_results_directory("ik_hjc_" + facingX.getName());
@@ -29,11 +29,58 @@
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Tools/IMUInverseKinematicsTool.h>
 
+#include "OrientationSensorPruning.h"
+
 #include <string>
+#include <vector>
+#include <cmath>
 #include <iostream>
 #include <clocale>
 #include <chrono> // for std::chrono functions
 
+const std::vector<std::string> orientationWeightSetFiles = {
+    "setup_OrientationWeightSet_uniform.xml",
+    "setup_OrientationWeightSet_pelvis_tibia_calcn.xml",
+    "setup_OrientationWeightSet_pelvis_tibia.xml",
+    "setup_OrientationWeightSet_pelvis_calcn.xml",
+    "setup_OrientationWeightSet_tibia_calcn.xml",
+    "setup_OrientationWeightSet_pelvis.xml"};
+
+// Runs IK on the trial with the given weights and orientations file and
+// returns the runtime in microseconds
+long long runIK(const OpenSim::OrientationWeightSet& weights,
+                const std::string& orientationsFile,
+                const std::string& outputMotionFile)
+{
+    OpenSim::IMUInverseKinematicsTool imuIk("setup_IMUInverseKinematics_trial.xml");
+    imuIk.set_results_directory("imuIkWeights");
+    imuIk.set_orientations_file(orientationsFile);
+    imuIk.set_orientation_weights(weights);
+    imuIk.set_output_motion_file(outputMotionFile);
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    imuIk.run(false);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+}
+
+double maxAbsDifference(const std::string& fileA, const std::string& fileB)
+{
+    const OpenSim::TimeSeriesTable a(fileA);
+    const OpenSim::TimeSeriesTable b(fileB);
+    const SimTK::Matrix& ma = a.getMatrix();
+    const SimTK::Matrix& mb = b.getMatrix();
+    if (ma.nrow() != mb.nrow() || ma.ncol() != mb.ncol()) {
+        return SimTK::Infinity;
+    }
+    double diff = 0;
+    for (int r = 0; r < ma.nrow(); ++r) {
+        for (int c = 0; c < ma.ncol(); ++c) {
+            diff = std::max(diff, std::abs(ma(r, c) - mb(r, c)));
+        }
+    }
+    return diff;
+}
+
 int main()
 {
     std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
@@ -42,8 +89,38 @@ int main()
     imuIk.set_results_directory("imuIk");
     imuIk.run(false);
 
+    // Time per frame of every weight set with all sensors in the reference
+    // data vs with the zero-weight sensors dropped from the orientations file
+    const std::string orientationsFile = imuIk.get_orientations_file();
+    const double tolerance = imuIk.get_accuracy();
+    bool prunedMatches = true;
+    for (const std::string& weightSetFile : orientationWeightSetFiles) {
+        const OpenSim::OrientationWeightSet weights(weightSetFile);
+        const std::string name = weights.getName();
+        const std::string prunedFile = name + "_active_orientations.sto";
+        const PrunedOrientations pruned = pruneOrientationsFile(
+                orientationsFile, zeroWeightSensors(weights), prunedFile);
+
+        const std::string fullMotion = "imuIkWeights/" + name + "_all_sensors.mot";
+        const std::string prunedMotion = "imuIkWeights/" + name + "_active_sensors.mot";
+        const long long fullTime = runIK(weights, orientationsFile, fullMotion);
+        const long long prunedTime = runIK(weights, prunedFile, prunedMotion);
+        const double diff = maxAbsDifference(fullMotion, prunedMotion);
+        prunedMatches = prunedMatches && diff <= tolerance;
+
+        const double frames = static_cast<double>(pruned.rows);
+        std::cout << name << ": active sensors = " << pruned.activeSensors
+                  << ", all sensors = " << fullTime / frames
+                  << "[µs/frame], active only = " << prunedTime / frames
+                  << "[µs/frame], max difference = " << diff << std::endl;
+    }
+
     std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
     std::cout << "Runtime = " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << "[µs]" << std::endl;
+    if (!prunedMatches) {
+        std::cout << "Pruned sensor IK differs from the full IK!" << std::endl;
+        return 1;
+    }
     std::cout << "Finished Running without Error!" << std::endl;
     return 0;
 }
@@ -0,0 +1,178 @@
+#ifndef OPENSIM_ORIENTATION_WINDOW_READER_H_
+#define OPENSIM_ORIENTATION_WINDOW_READER_H_
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  OrientationWindowReader.h                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Common/Exception.h>
+#include <OpenSim/Common/TimeSeriesTable.h>
+
+#include <array>
+#include <charconv>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Rows of a quaternion .sto file (as written by STOFileAdapter) within a time
+// window. The file is read line by line and parsing stops at the first row
+// past the window's end, so the cost is O(window) rather than O(trial).
+// Numbers are parsed with std::from_chars, which ignores the C locale.
+struct OrientationWindow {
+  std::vector<std::pair<std::string, std::string>> metadata; // key=value
+  std::vector<std::string> labels;
+  std::vector<double> times;
+  std::vector<std::array<double, 4>> values; // w, x, y, z; row-major
+  std::size_t rowsParsed = 0; // rows read, including those before startTime
+};
+
+namespace OrientationWindowDetail {
+
+inline double parseDouble(const char *&first, const char *last,
+                          const std::string &fileName) {
+  while (first != last && *first == ' ') {
+    ++first;
+  }
+  double value = 0;
+  const auto [ptr, ec] = std::from_chars(first, last, value);
+  OPENSIM_THROW_IF(ec != std::errc(), OpenSim::Exception,
+                   "Could not parse a number in " + fileName);
+  first = ptr;
+  return value;
+}
+
+inline void split(const std::string &line, char delimiter,
+                  std::vector<std::string> &tokens) {
+  tokens.clear();
+  std::size_t start = 0;
+  while (true) {
+    const std::size_t end = line.find(delimiter, start);
+    tokens.push_back(line.substr(start, end - start));
+    if (end == std::string::npos) {
+      break;
+    }
+    start = end + 1;
+  }
+}
+
+} // namespace OrientationWindowDetail
+
+// Rows with startTime <= time <= endTime, at most maxRows of them
+inline OrientationWindow readOrientationRows(
+    const std::string &fileName, double startTime, double endTime,
+    std::size_t maxRows = std::numeric_limits<std::size_t>::max()) {
+  std::ifstream file(fileName);
+  OPENSIM_THROW_IF(!file, OpenSim::Exception, "Could not open " + fileName);
+
+  OrientationWindow window;
+  std::string line;
+  // Header: key=value lines up to endheader, then the column labels
+  while (std::getline(file, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (line == "endheader") {
+      break;
+    }
+    const std::size_t equals = line.find('=');
+    if (equals != std::string::npos) {
+      window.metadata.emplace_back(line.substr(0, equals),
+                                   line.substr(equals + 1));
+    }
+  }
+  OPENSIM_THROW_IF(!std::getline(file, line), OpenSim::Exception,
+                   "No column labels in " + fileName);
+  if (!line.empty() && line.back() == '\r') {
+    line.pop_back();
+  }
+  OrientationWindowDetail::split(line, '\t', window.labels);
+  window.labels.erase(window.labels.begin()); // time
+  const std::size_t numColumns = window.labels.size();
+
+  while (std::getline(file, line)) {
+    if (line.empty() || line == "\r") {
+      continue;
+    }
+    const char *first = line.data();
+    const char *last = first + line.size();
+    const double time =
+        OrientationWindowDetail::parseDouble(first, last, fileName);
+    if (time > endTime) {
+      break;
+    }
+    ++window.rowsParsed;
+    if (time < startTime) {
+      continue;
+    }
+    window.times.push_back(time);
+    for (std::size_t c = 0; c < numColumns; ++c) {
+      OPENSIM_THROW_IF(first == last || *first != '\t', OpenSim::Exception,
+                       "Missing column in " + fileName);
+      ++first;
+      std::array<double, 4> q;
+      for (int k = 0; k < 4; ++k) {
+        if (k > 0) {
+          OPENSIM_THROW_IF(first == last || *first != ',', OpenSim::Exception,
+                           "Malformed quaternion in " + fileName);
+          ++first;
+        }
+        q[k] = OrientationWindowDetail::parseDouble(first, last, fileName);
+      }
+      window.values.push_back(q);
+    }
+    if (window.times.size() == maxRows) {
+      break;
+    }
+  }
+  return window;
+}
+
+// The window as a table, equal to the same rows of
+// TimeSeriesTable_<SimTK::Quaternion>(fileName)
+inline OpenSim::TimeSeriesTable_<SimTK::Quaternion> readOrientationWindow(
+    const std::string &fileName, double startTime, double endTime,
+    std::size_t maxRows = std::numeric_limits<std::size_t>::max()) {
+  const OrientationWindow window =
+      readOrientationRows(fileName, startTime, endTime, maxRows);
+  OPENSIM_THROW_IF(window.times.empty(), OpenSim::Exception,
+                   "No rows in the time window of " + fileName);
+  const int numRows = static_cast<int>(window.times.size());
+  const int numColumns = static_cast<int>(window.labels.size());
+  SimTK::Matrix_<SimTK::Quaternion> data(numRows, numColumns);
+  for (int r = 0; r < numRows; ++r) {
+    for (int c = 0; c < numColumns; ++c) {
+      const std::array<double, 4> &q =
+          window.values[std::size_t(r) * numColumns + c];
+      data(r, c) = SimTK::Quaternion(q[0], q[1], q[2], q[3]);
+    }
+  }
+  OpenSim::TimeSeriesTable_<SimTK::Quaternion> table(window.times, data,
+                                                     window.labels);
+  for (const auto &entry : window.metadata) {
+    table.updTableMetaData().setValueForKey(entry.first, entry.second);
+  }
+  return table;
+}
+
+#endif // OPENSIM_ORIENTATION_WINDOW_READER_H_
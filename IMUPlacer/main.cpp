@@ -30,6 +30,13 @@
 #include <OpenSim/Tools/IMUInverseKinematicsTool.h>
 #include <OpenSim/OpenSim.h>
 
+#include "CalibrationWindow.h"
+
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <string>
+
 int main() {
     std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
 
@@ -42,7 +49,45 @@ int main() {
     rajagopalImuPlacer.run();
     OpenSim::Model rajagopalModel = rajagopalImuPlacer.getCalibratedModel();
 
+    std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+
+    // Same calibrations from one read of the orientations: both setups use the
+    // same file and sensor rotations, so the rotated calibration row is
+    // written once and both models are placed against it concurrently
+    const std::string windowFile = "l_comf_01-000_calibration_window.sto";
+    writeCalibrationWindow(gait2392ImuPlacer.get_orientation_file_for_calibration(),
+        gait2392ImuPlacer.get_sensor_to_opensim_rotations(), windowFile);
+    OpenSim::IMUPlacer gait2392SharedPlacer("gait2392_imuPlacer.xml");
+    OpenSim::IMUPlacer rajagopalSharedPlacer("Rajagopal2015_imuPlacer.xml");
+    gait2392SharedPlacer.set_output_model_file("calibrated_shared_gait2392_thelen2003muscle.osim");
+    rajagopalSharedPlacer.set_output_model_file("calibrated_shared_Rajagopal2015_opensense.osim");
+    auto gait2392Placed = std::async(std::launch::async,
+        [&] { return placeWithWindow(gait2392SharedPlacer, windowFile); });
+    auto rajagopalPlaced = std::async(std::launch::async,
+        [&] { return placeWithWindow(rajagopalSharedPlacer, windowFile); });
+    const bool placed = gait2392Placed.get() && rajagopalPlaced.get();
+
     std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    std::cout << "Sequential = "
+              << std::chrono::duration_cast<std::chrono::microseconds>(middle - begin).count()
+              << "[µs], Shared calibration window = "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count()
+              << "[µs]" << std::endl;
+
+    // Only the rotation of the sensor data is regrouped, so the placements
+    // agree to rounding
+    const double tolerance = 1e-9;
+    const double gait2392Difference = maxImuOffsetDifference(
+        gait2392Model, gait2392SharedPlacer.getCalibratedModel());
+    const double rajagopalDifference = maxImuOffsetDifference(
+        rajagopalModel, rajagopalSharedPlacer.getCalibratedModel());
+    std::cout << "Max IMU offset difference gait2392 = " << gait2392Difference
+              << ", Rajagopal2015 = " << rajagopalDifference << std::endl;
+    if (!placed || gait2392Difference > tolerance || rajagopalDifference > tolerance) {
+        std::cout << "Shared calibration DIFFERS" << std::endl;
+        return 1;
+    }
+
     std::cout << "Runtime = " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << "[µs]" << std::endl;
     std::cout << "Finished Running without Error!" << std::endl;
     return 0;
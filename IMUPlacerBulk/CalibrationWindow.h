@@ -0,0 +1,104 @@
+#ifndef OPENSIM_CALIBRATION_WINDOW_H_
+#define OPENSIM_CALIBRATION_WINDOW_H_
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  CalibrationWindow.h                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Common/STOFileAdapter.h>
+#include <OpenSim/Common/TimeSeriesTable.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/OpenSense/IMUPlacer.h>
+#include <OpenSim/Simulation/OpenSense/OpenSenseUtilities.h>
+
+#include "OrientationWindowReader.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+// IMUPlacer only calibrates from the first row of its orientations file, after
+// parsing the whole trial and rotating it from sensor into OpenSim space. Here
+// only the calibration row is read (parsing stops right after it) and rotated,
+// and written to a one-row window file. Models calibrated against the same
+// trial share that window. Every placer then reads the window with zero
+// sensor rotations; the heading correction still runs per model because it
+// depends on the model's default pose.
+
+// First row of `orientationsFile` at or after `startTime`, rotated by the
+// space-fixed XYZ `sensorToOpenSimRotations` as IMUPlacer::run() rotates it.
+inline OpenSim::TimeSeriesTable_<SimTK::Quaternion> readCalibrationWindow(
+    const std::string &orientationsFile,
+    const SimTK::Vec3 &sensorToOpenSimRotations,
+    double startTime = -std::numeric_limits<double>::infinity()) {
+  OpenSim::TimeSeriesTable_<SimTK::Quaternion> window = readOrientationWindow(
+      orientationsFile, startTime, std::numeric_limits<double>::infinity(), 1);
+  const SimTK::Rotation sensorToOpenSim(
+      SimTK::BodyOrSpaceType::SpaceRotationSequence,
+      sensorToOpenSimRotations[0], SimTK::XAxis, sensorToOpenSimRotations[1],
+      SimTK::YAxis, sensorToOpenSimRotations[2], SimTK::ZAxis);
+  OpenSim::OpenSenseUtilities::rotateOrientationTable(window, sensorToOpenSim);
+  return window;
+}
+
+// Writes the window of `orientationsFile` to `windowFile` for placeWithWindow()
+inline void writeCalibrationWindow(
+    const std::string &orientationsFile,
+    const SimTK::Vec3 &sensorToOpenSimRotations, const std::string &windowFile,
+    double startTime = -std::numeric_limits<double>::infinity()) {
+  OpenSim::STOFileAdapter_<SimTK::Quaternion>::write(
+      readCalibrationWindow(orientationsFile, sensorToOpenSimRotations,
+                            startTime),
+      windowFile);
+}
+
+// Calibrates `placer` against an already rotated window file
+inline bool placeWithWindow(OpenSim::IMUPlacer &placer,
+                            const std::string &windowFile) {
+  placer.set_orientation_file_for_calibration(windowFile);
+  placer.set_sensor_to_opensim_rotations(SimTK::Vec3(0));
+  return placer.run(false);
+}
+
+// Largest difference between the offset transforms of the IMU frames (*_imu)
+// of two calibrated models
+inline double maxImuOffsetDifference(const OpenSim::Model &a,
+                                     const OpenSim::Model &b) {
+  double maxDifference = 0;
+  for (const auto &frame :
+       a.getComponentList<OpenSim::PhysicalOffsetFrame>()) {
+    const std::string &name = frame.getName();
+    if (name.size() < 4 || name.compare(name.size() - 4, 4, "_imu") != 0) {
+      continue;
+    }
+    const auto &other = b.getComponent<OpenSim::PhysicalOffsetFrame>(
+        frame.getAbsolutePathString());
+    const SimTK::Transform &x = frame.getOffsetTransform();
+    const SimTK::Transform &y = other.getOffsetTransform();
+    maxDifference = std::max(maxDifference, (x.p() - y.p()).normInf());
+    maxDifference = std::max(maxDifference,
+                             (x.R().asMat33() - y.R().asMat33()).normInf());
+  }
+  return maxDifference;
+}
+
+#endif // OPENSIM_CALIBRATION_WINDOW_H_
@@ -7,6 +7,9 @@
 
 // Thread Pool
 #include "BS_thread_pool.hpp" // BS::synced_stream, BS::thread_pool
+#include "CalibrationWindow.h"
+#include "IMUPlacementDelta.h"
+#include "ParticipantStore.h"
 
 #include <algorithm> // For std::find_if
 #include <chrono>    // for std::chrono functions
@@ -38,6 +41,7 @@ const std::vector<std::string> baseModels = {
 
 // Simple test case
 const std::vector<std::string> includedParticipants = {"01"};
+const std::string fileNameParticipants = "info_participants.csv";
 
 // All trials with no invalid trials
 // const std::vector<std::string> includedParticipants = {
@@ -48,9 +52,19 @@ const std::string outputBasePrefix = "kg";
 const std::string imuSuffix = "and_IMUs";
 
 const std::string sep = "_";
-
+// Known working sensor to OpenSim rotations for the kuopio gait dataset
+// 90 0 90: SimTK::Vec3(-SimTK::Pi / 2, SimTK::Pi, 0)
+const SimTK::Vec3 sensorToOpenSimRotations(-SimTK::Pi / 2, SimTK::Pi / 2, 0);
+const std::string calibrationWindowSuffix = "calibration_window";
+
+// calibrationFile/sensorRotations: the orientations IMUPlacer calibrates from,
+// either the trial itself or its shared, already rotated calibration window.
+// writeDelta: write only the IMU frames (IMUPlacementDelta.h) instead of the
+// whole calibrated model
 void process(const std::filesystem::path &file,
-             const std::filesystem::path &resultDir, const ConfigType &c) {
+             const std::filesystem::path &resultDir, const ConfigType &c,
+             const std::filesystem::path &calibrationFile,
+             const SimTK::Vec3 &sensorRotations, bool writeDelta) {
   sync_out.println("---Starting Model Processing: ", file.string());
   try {
     const std::filesystem::path modelSourcePath = c.second;
@@ -67,26 +81,34 @@ void process(const std::filesystem::path &file,
       OpenSim::IMUPlacer imuPlacer;
       imuPlacer.set_base_imu_label("pelvis_imu");
       imuPlacer.set_base_heading_axis("-z");
-      // 90 0 90
-      // imuPlacer.set_sensor_to_opensim_rotations(
-      //     SimTK::Vec3(-SimTK::Pi / 2, SimTK::Pi, 0));
-      // Known working
-      imuPlacer.set_sensor_to_opensim_rotations(
-          SimTK::Vec3(-SimTK::Pi / 2, SimTK::Pi / 2, 0));
+      imuPlacer.set_sensor_to_opensim_rotations(sensorRotations);
 
-      imuPlacer.set_orientation_file_for_calibration(file.string());
+      imuPlacer.set_orientation_file_for_calibration(calibrationFile.string());
 
       imuPlacer.set_model_file(modelSourcePath.string());
 
       const std::string scaledOutputModelFilePrefix =
           outputFilePrefix + sep + imuSuffix;
-      const std::string scaledOutputModelFile =
-          resultDir /
-          (scaledOutputModelFilePrefix + modelSourcePath.extension().string());
-      sync_out.println("Scaled Output Model File: ", scaledOutputModelFile);
-
-      imuPlacer.set_output_model_file(scaledOutputModelFile);
-      imuPlacer.run();
+      if (writeDelta) {
+        const std::string deltaFile =
+            resultDir / (scaledOutputModelFilePrefix + imuDeltaExtension);
+        sync_out.println("IMU Placement Delta File: ", deltaFile);
+
+        imuPlacer.set_output_model_file("");
+        imuPlacer.run();
+        writeIMUDelta(
+            extractIMUDelta(imuPlacer.getCalibratedModel(),
+                            std::filesystem::absolute(modelSourcePath).string()),
+            deltaFile);
+      } else {
+        const std::string scaledOutputModelFile =
+            resultDir /
+            (scaledOutputModelFilePrefix + modelSourcePath.extension().string());
+        sync_out.println("Scaled Output Model File: ", scaledOutputModelFile);
+
+        imuPlacer.set_output_model_file(scaledOutputModelFile);
+        imuPlacer.run();
+      }
 
       // Fix bug for set_model_file
       // OpenSim::IMUPlacer imuPlacer2;
@@ -181,6 +203,29 @@ void process(const std::filesystem::path &file,
                    " File: ", file.stem().string());
 }
 
+// Shared calibration: read and rotate the trial's calibration row once, then
+// place IMUs on every base model concurrently against it
+void processTrial(BS::thread_pool &pool, const std::filesystem::path &file,
+                  const std::filesystem::path &resultDir,
+                  const std::filesystem::path &modelPath, bool writeDelta) {
+  const std::filesystem::path windowFile =
+      resultDir / (file.stem().string() + sep + calibrationWindowSuffix +
+                   file.extension().string());
+  try {
+    writeCalibrationWindow(file.string(), sensorToOpenSimRotations,
+                           windowFile.string());
+  } catch (const std::exception &e) {
+    sync_out.println("Error in calibration window: ", e.what());
+    return;
+  }
+  for (const auto &m : baseModels) {
+    const ConfigType config = {"", (modelPath / m).string()};
+    pool.detach_task([file, resultDir, config, windowFile, writeDelta] {
+      process(file, resultDir, config, windowFile, SimTK::Vec3(0), writeDelta);
+    });
+  }
+}
+
 void collectFiles(const std::filesystem::path &directory,
                   std::vector<std::filesystem::path> &files) {
   // Check if the path is a directory
@@ -198,10 +243,14 @@ void collectFiles(const std::filesystem::path &directory,
   }
 }
 
-// Function to filter files based on specific criteria
-void filterFiles(const std::vector<std::filesystem::path> &allFiles,
-                 std::vector<std::filesystem::path> &filteredFiles,
-                 const std::vector<std::string> &includedParticipants) {
+// Function to filter files based on specific criteria. An empty
+// includedParticipants selects everyone; files the participant store rules
+// out (unknown participant, invalid trial) are dropped and counted.
+std::size_t filterFiles(const std::vector<std::filesystem::path> &allFiles,
+                        std::vector<std::filesystem::path> &filteredFiles,
+                        const ParticipantStore &participants,
+                        const std::vector<std::string> &includedParticipants) {
+  std::size_t skipped = 0;
   for (const auto &path : allFiles) {
     std::string filename = path.stem().string();
 
@@ -214,17 +263,23 @@ void filterFiles(const std::vector<std::filesystem::path> &allFiles,
     // Check if the participant ID is in the included list
     const auto it = std::find(includedParticipants.begin(),
                               includedParticipants.end(), participantId);
-    const bool participantIncluded = it != includedParticipants.end();
+    const bool participantIncluded =
+        includedParticipants.empty() || it != includedParticipants.end();
 
     // Check the file extension and naming conditions
     if (path.extension() == ".sto" &&
         (filename.rfind("data_l_", 0) == 0 ||
          filename.rfind("data_r_", 0) == 0) &&
         filename.ends_with("_orientations") && participantIncluded) {
+      if (!participants.isRunnable(participantId, filename)) {
+        ++skipped;
+        continue;
+      }
       // Add the file to the filtered vector if all conditions are met
       filteredFiles.push_back(path);
     }
   }
+  return skipped;
 }
 
 // Function to create the required directory structure
@@ -252,9 +307,24 @@ int main(int argc, char *argv[]) {
       std::chrono::steady_clock::now();
   if (argc < 4) {
     std::cerr << "Usage: " << argv[0]
-              << " <directory_path> <models_path> <output_path>" << std::endl;
+              << " <directory_path> <models_path> <output_path> "
+                 "[--shared-calibration] [--delta]"
+              << std::endl;
     return 1;
   }
+  bool sharedCalibration = false;
+  bool writeDelta = false;
+  for (int i = 4; i < argc; ++i) {
+    const std::string option = argv[i];
+    if (option == "--shared-calibration") {
+      sharedCalibration = true;
+    } else if (option == "--delta") {
+      writeDelta = true;
+    } else {
+      std::cerr << "Unknown option: " << option << std::endl;
+      return 1;
+    }
+  }
 
   std::filesystem::path directoryPath = argv[1];
   if (!std::filesystem::exists(directoryPath) ||
@@ -290,8 +360,12 @@ int main(int argc, char *argv[]) {
   collectFiles(directoryPath, allFiles);
 
   // Filter the collected files based on the criteria
+  const ParticipantStore participants(fileNameParticipants);
   std::vector<std::filesystem::path> filteredFiles;
-  filterFiles(allFiles, filteredFiles, includedParticipants);
+  const std::size_t skipped =
+      filterFiles(allFiles, filteredFiles, participants, includedParticipants);
+  sync_out.println("Trials: ", filteredFiles.size(),
+                   " skipped (invalid): ", skipped);
 
   // Create directories for each filtered file
   for (const auto &file : filteredFiles) {
@@ -303,17 +377,24 @@ int main(int argc, char *argv[]) {
 
   // Generate subject and trial specific models
   for (const auto &file : filteredFiles) {
+    // Find the Model
+    const std::filesystem::path firstParent = file.parent_path();
+    const std::filesystem::path secondParent = firstParent.parent_path();
+    const std::filesystem::path modelPath =
+        modelsPath / secondParent.filename();
+    const std::filesystem::path resultDir =
+        outputPath / secondParent.filename() / firstParent.filename() / "";
+    if (sharedCalibration) {
+      pool.detach_task([&pool, file, resultDir, modelPath, writeDelta] {
+        processTrial(pool, file, resultDir, modelPath, writeDelta);
+      });
+      continue;
+    }
     for (const auto &m : baseModels) {
-      // Find the Model
-      const std::filesystem::path firstParent = file.parent_path();
-      const std::filesystem::path secondParent = firstParent.parent_path();
-      const std::filesystem::path modelPath =
-          modelsPath / secondParent.filename();
-      const std::filesystem::path resultDir =
-          outputPath / secondParent.filename() / firstParent.filename() / "";
       const ConfigType newConfig = {"", (modelPath / m).string()};
-      pool.detach_task([file, resultDir, newConfig] {
-        process(file, resultDir, newConfig);
+      pool.detach_task([file, resultDir, newConfig, writeDelta] {
+        process(file, resultDir, newConfig, file, sensorToOpenSimRotations,
+                writeDelta);
       });
     }
   }
@@ -0,0 +1,145 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  AllPairsBodyKinematics.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include "AllPairsBodyKinematics.h"
+
+#include <OpenSim/Simulation/Model/Model.h>
+
+#include <algorithm>
+
+using namespace OpenSim;
+
+AllPairsBodyKinematics::AllPairsBodyKinematics() : Analysis() {
+    constructProperties();
+    setName("AllPairsBodyKinematics");
+}
+
+AllPairsBodyKinematics::AllPairsBodyKinematics(Model* model) : Analysis(model) {
+    constructProperties();
+    setName("AllPairsBodyKinematics");
+    if (model) setModel(*model);
+}
+
+void AllPairsBodyKinematics::constructProperties() {
+    constructProperty_include_accelerations(true);
+    constructProperty_write_text(false);
+    constructProperty_chunk_rows(1024);
+}
+
+void AllPairsBodyKinematics::setModel(Model& model) {
+    Analysis::setModel(model);
+    _bodies.clear();
+    for (const Body& body : model.getComponentList<Body>()) {
+        _bodies.push_back(&body);
+    }
+    const std::size_t n = _bodies.size();
+    _groundTransforms.resize(n);
+    _originVelocities.resize(n);
+    _originAccelerations.resize(n);
+    setupTable();
+}
+
+void AllPairsBodyKinematics::setupTable() {
+    const bool withAcc = get_include_accelerations();
+    std::vector<std::string> labels;
+    for (const Body* body : _bodies) {
+        for (const Body* relativeTo : _bodies) {
+            const std::string pair =
+                    body->getName() + "-" + relativeTo->getName();
+            for (const char* quantity : {"pos", "vel", "acc"}) {
+                if (!withAcc && quantity[0] == 'a') continue;
+                for (const char* axis : {"X", "Y", "Z"}) {
+                    labels.push_back(pair + "_" + quantity + "_" + axis);
+                }
+            }
+        }
+    }
+    _row.assign(labels.size(), SimTK::NaN);
+    _table = std::make_unique<ColumnarTableWriter>(
+            labels, static_cast<std::uint32_t>(std::max(get_chunk_rows(), 1)));
+}
+
+int AllPairsBodyKinematics::record(const SimTK::State& s) {
+    const bool withAcc = get_include_accelerations();
+    _model->getMultibodySystem().realize(s,
+            withAcc ? SimTK::Stage::Acceleration : SimTK::Stage::Velocity);
+
+    const std::size_t n = _bodies.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        const Body& body = *_bodies[i];
+        _groundTransforms[i] = body.getTransformInGround(s);
+        _originVelocities[i] = body.getVelocityInGround(s)[1];
+        if (withAcc) {
+            _originAccelerations[i] = body.getAccelerationInGround(s)[1];
+        }
+    }
+
+    // Same as SimbodyEngine::transformPosition/transform from ground into
+    // relative_to, which is what PointKinematics records
+    double* out = _row.data();
+    for (std::size_t i = 0; i < n; ++i) {
+        const SimTK::Vec3& origin = _groundTransforms[i].p();
+        for (std::size_t j = 0; j < n; ++j) {
+            const SimTK::Transform& X_GR = _groundTransforms[j];
+            const SimTK::Vec3 pos = ~X_GR * origin;
+            const SimTK::Vec3 vel = ~X_GR.R() * _originVelocities[i];
+            for (int k = 0; k < 3; ++k) *out++ = pos[k];
+            for (int k = 0; k < 3; ++k) *out++ = vel[k];
+            if (withAcc) {
+                const SimTK::Vec3 acc = ~X_GR.R() * _originAccelerations[i];
+                for (int k = 0; k < 3; ++k) *out++ = acc[k];
+            }
+        }
+    }
+    _table->appendRow(s.getTime(), _row.data());
+    return 0;
+}
+
+int AllPairsBodyKinematics::begin(const SimTK::State& s) {
+    if (!proceed()) return 0;
+    _table->clear();
+    return record(s);
+}
+
+int AllPairsBodyKinematics::step(const SimTK::State& s, int stepNumber) {
+    if (!proceed(stepNumber)) return 0;
+    return record(s);
+}
+
+int AllPairsBodyKinematics::end(const SimTK::State& s) {
+    if (!proceed()) return 0;
+    return record(s);
+}
+
+int AllPairsBodyKinematics::printResults(const std::string& baseName,
+        const std::string& dir, double dT, const std::string& extension) {
+    // dT resampling does not apply; rows are written as recorded
+    const std::string name = baseName + "_" + getName();
+    const std::string path = dir.empty() ? name : dir + "/" + name;
+    _table->write(path + columnarExtension);
+    if (get_write_text()) {
+        exportColumnarTableToSto(path + columnarExtension, path + extension);
+    }
+    return 0;
+}
@@ -0,0 +1,218 @@
+#ifndef OPENSIM_FRAME_PARALLEL_ANALYZE_H_
+#define OPENSIM_FRAME_PARALLEL_ANALYZE_H_
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  FrameParallelAnalyze.h                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Analyses/BodyKinematics.h>
+#include <OpenSim/Analyses/IMUDataReporter.h>
+#include <OpenSim/Analyses/Kinematics.h>
+#include <OpenSim/Analyses/PointKinematics.h>
+#include <OpenSim/Common/Storage.h>
+#include <OpenSim/Tools/AnalyzeTool.h>
+
+#include "AllPairsBodyKinematics.h"
+#include "ColumnarTable.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <string>
+#include <vector>
+
+// AnalyzeTool sets every frame's state from the coordinates file and steps
+// its analyses one frame after another. Analyses that only record kinematics
+// of the current state do not depend on earlier frames, so the frames can be
+// split into contiguous chunks, each analyzed by its own AnalyzeTool (own
+// model, analyses and SimTK::State) on its own thread. The chunk outputs are
+// concatenated in time order; since every row is computed and formatted the
+// same way as in the serial run, the merged files match it.
+
+// Why the tool's analyses cannot be split across frames; empty if they can
+inline std::string frameParallelBlocker(const OpenSim::AnalyzeTool& tool)
+{
+    if (tool.getStatesFileName() != "" || tool.getCoordinatesFileName() == "") {
+        return "frames must come from a coordinates file";
+    }
+    if (tool.getLowpassCutoffFrequency() >= 0) {
+        return "low-pass filtering resamples the coordinates";
+    }
+    if (tool.getSolveForEquilibrium()) {
+        return "solving for equilibrium of auxiliary states";
+    }
+    const OpenSim::AnalysisSet& analyses = tool.getAnalysisSet();
+    for (int i = 0; i < analyses.getSize(); ++i) {
+        const OpenSim::Analysis& analysis = analyses.get(i);
+        if (!analysis.getOn()) continue;
+        if (analysis.getStepInterval() != 1) {
+            return analysis.getName() + " does not record every frame";
+        }
+        if (const auto* reporter =
+                    dynamic_cast<const OpenSim::IMUDataReporter*>(&analysis)) {
+            if (!reporter->get_compute_accelerations_without_forces()) {
+                return analysis.getName() + " computes accelerations from forces";
+            }
+            continue;
+        }
+        if (dynamic_cast<const OpenSim::PointKinematics*>(&analysis) ||
+                dynamic_cast<const OpenSim::BodyKinematics*>(&analysis) ||
+                dynamic_cast<const OpenSim::Kinematics*>(&analysis) ||
+                dynamic_cast<const OpenSim::AllPairsBodyKinematics*>(&analysis)) {
+            continue;
+        }
+        return analysis.getName() + " (" + analysis.getConcreteClassName() +
+               ") is not a kinematics-only analysis";
+    }
+    return "";
+}
+
+// Appends the rows of `chunk` to `merged`; the header and column labels are
+// only taken from the first chunk. nRows in the header, if present, is fixed
+// up by the caller.
+inline void appendChunkRows(std::ifstream& chunk, std::ofstream& merged,
+                            bool withHeader, std::size_t& rows)
+{
+    std::string line;
+    bool inHeader = true;
+    bool labels = false;
+    while (std::getline(chunk, line)) {
+        if (inHeader) {
+            if (withHeader) merged << line << '\n';
+            if (line.rfind("endheader", 0) == 0) {
+                inHeader = false;
+                labels = true;
+            }
+        } else if (labels) {
+            if (withHeader) merged << line << '\n';
+            labels = false;
+        } else if (!line.empty()) {
+            merged << line << '\n';
+            ++rows;
+        }
+    }
+}
+
+// Runs the analyses of an AnalyzeTool setup file over frame chunks on up to
+// `numThreads` threads and writes the merged outputs into the tool's results
+// directory. Falls back to a serial AnalyzeTool run if the analysis set is
+// not kinematics-only. Returns the number of chunks used (1 = serial).
+inline int runFrameParallel(const std::string& setupFile, unsigned numThreads,
+                            const std::string& resultsDir = "")
+{
+    OpenSim::AnalyzeTool setup(setupFile, false);
+    const std::string outputDir =
+            resultsDir.empty() ? setup.getResultsDir() : resultsDir;
+
+    // Frames the serial tool would visit
+    std::vector<double> times;
+    const std::string blocker = frameParallelBlocker(setup);
+    if (blocker.empty()) {
+        const OpenSim::Storage coordinates(setup.getCoordinatesFileName());
+        for (int i = 0; i < coordinates.getSize(); ++i) {
+            const double t = coordinates.getStateVector(i)->getTime();
+            if (t >= setup.getInitialTime() && t <= setup.getFinalTime()) {
+                times.push_back(t);
+            }
+        }
+    } else {
+        std::cout << "Frame parallel analysis not possible: " << blocker
+                  << std::endl;
+    }
+
+    // At least two frames per chunk so begin() and end() see distinct states
+    const std::size_t chunks = std::max<std::size_t>(1,
+            std::min<std::size_t>(numThreads, times.size() / 2));
+    if (chunks == 1) {
+        OpenSim::AnalyzeTool tool(setupFile);
+        tool.setResultsDir(outputDir);
+        tool.run();
+        return 1;
+    }
+
+    const std::filesystem::path chunkRoot =
+            std::filesystem::path(outputDir) / "frame_chunks";
+    std::vector<std::filesystem::path> chunkDirs;
+    std::vector<std::future<void>> runs;
+    for (std::size_t c = 0; c < chunks; ++c) {
+        const std::size_t first = times.size() * c / chunks;
+        const std::size_t last = times.size() * (c + 1) / chunks - 1;
+        chunkDirs.push_back(chunkRoot / ("chunk_" + std::to_string(c)));
+        std::filesystem::create_directories(chunkDirs.back());
+        runs.push_back(std::async(std::launch::async,
+                [&setupFile, dir = chunkDirs.back().string(),
+                 ti = times[first], tf = times[last]] {
+                    OpenSim::AnalyzeTool tool(setupFile);
+                    tool.setInitialTime(ti);
+                    tool.setFinalTime(tf);
+                    tool.setResultsDir(dir);
+                    tool.run();
+                }));
+    }
+    for (auto& run : runs) {
+        run.get();
+    }
+
+    // Every chunk writes the same set of files
+    std::filesystem::create_directories(outputDir);
+    for (const auto& entry :
+            std::filesystem::directory_iterator(chunkDirs.front())) {
+        if (!entry.is_regular_file()) continue;
+        const std::string fileName = entry.path().filename().string();
+        const std::filesystem::path mergedFile =
+                std::filesystem::path(outputDir) / fileName;
+        if (entry.path().extension() == columnarExtension) {
+            std::vector<std::string> chunkFiles;
+            for (std::size_t c = 0; c < chunks; ++c) {
+                chunkFiles.push_back((chunkDirs[c] / fileName).string());
+            }
+            concatenateColumnarTables(chunkFiles, mergedFile.string());
+            continue;
+        }
+        std::size_t rows = 0;
+        {
+            std::ofstream merged(mergedFile);
+            for (std::size_t c = 0; c < chunks; ++c) {
+                std::ifstream chunk(chunkDirs[c] / fileName);
+                appendChunkRows(chunk, merged, c == 0, rows);
+            }
+        }
+        // Storage::print writes the row count into the header
+        std::ifstream in(mergedFile);
+        std::string contents((std::istreambuf_iterator<char>(in)),
+                             std::istreambuf_iterator<char>());
+        in.close();
+        const std::size_t nRows = contents.find("\nnRows=");
+        const std::size_t header = contents.find("endheader");
+        if (nRows != std::string::npos && nRows < header) {
+            const std::size_t eol = contents.find('\n', nRows + 1);
+            contents.replace(nRows + 1, eol - nRows - 1,
+                             "nRows=" + std::to_string(rows));
+            std::ofstream(mergedFile) << contents;
+        }
+    }
+    std::filesystem::remove_all(chunkRoot);
+    return static_cast<int>(chunks);
+}
+
+#endif // OPENSIM_FRAME_PARALLEL_ANALYZE_H_
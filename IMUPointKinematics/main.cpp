@@ -31,15 +31,110 @@
 
 #include <OpenSim/Analyses/PointKinematics.h>
 
+#include "AllPairsBodyKinematics.h"
+#include "ColumnarTable.h"
+#include "FrameParallelAnalyze.h"
+
 #include <string>
+#include <vector>
+#include <thread>
+#include <iterator>
+#include <cmath>
+#include <fstream>
+#include <filesystem>
 #include <iostream>
 #include <clocale>
 #include <chrono> // for std::chrono functions
 
-int main()
+// Peak resident set size of this process in kB, -1 where /proc is missing
+long peakMemoryKB()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::stol(line.substr(6));
+        }
+    }
+    return -1;
+}
+
+// Largest difference between the AllPairsBodyKinematics table and the
+// per-pair PointKinematics files of an earlier run in the same results
+// directory; -1 if those files are missing. Only the columns of one pair are
+// loaded from the columnar file at a time.
+double compareWithPointKinematics(const std::string& allPairsFile,
+                                  const std::string& pointKinematicsPrefix,
+                                  const std::vector<std::string>& bodies)
+{
+    const ColumnarTableReader allPairs(allPairsFile);
+    double diff = 0;
+    for (const std::string& root : bodies) {
+        for (const std::string& relativeTo : bodies) {
+            const std::string pair = root + "-" + relativeTo;
+            for (const std::string quantity : {"pos", "vel", "acc"}) {
+                const std::string file =
+                        pointKinematicsPrefix + pair + "_" + quantity + ".sto";
+                if (!std::filesystem::exists(file)) {
+                    return -1;
+                }
+                const OpenSim::TimeSeriesTable single(file);
+                if (single.getNumRows() != allPairs.getNumRows()) {
+                    return SimTK::Infinity;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    const std::string axis(1, "XYZ"[k]);
+                    const std::vector<double> a = allPairs.readColumn(
+                            pair + "_" + quantity + "_" + axis);
+                    const auto b = single.getDependentColumnAtIndex(k);
+                    for (int r = 0; r < b.size(); ++r) {
+                        diff = std::max(diff, std::abs(a[r] - b[r]));
+                    }
+                }
+            }
+        }
+    }
+    return diff;
+}
+
+// Files of `dir` that are missing from or differ byte-wise in `reference`
+int countDifferingFiles(const std::string& dir, const std::string& reference)
+{
+    int differing = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (!entry.is_regular_file()) continue;
+        std::ifstream a(entry.path());
+        std::ifstream b(std::filesystem::path(reference) / entry.path().filename());
+        const std::string ca((std::istreambuf_iterator<char>(a)),
+                             std::istreambuf_iterator<char>());
+        const std::string cb((std::istreambuf_iterator<char>(b)),
+                             std::istreambuf_iterator<char>());
+        if (!b || ca != cb) {
+            std::cout << "Differs from serial run: " << entry.path() << std::endl;
+            ++differing;
+        }
+    }
+    return differing;
+}
+
+int main(int argc, char* argv[])
 {
     std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
 
+    // ./main                  one PointKinematics per ordered body pair (N^2)
+    // ./main --all-pairs      a single AllPairsBodyKinematics; run after
+    //                         ./main to also check it against the N^2 outputs
+    // ./main --frame-parallel also run the same setup split over frames on
+    //                         all cores and check it matches the serial run
+    bool allPairs = false;
+    bool frameParallel = false;
+    for (int a = 1; a < argc; ++a) {
+        const std::string arg = argv[a];
+        allPairs = allPairs || arg == "--all-pairs";
+        frameParallel = frameParallel || arg == "--frame-parallel";
+    }
+    OpenSim::Object::registerType(OpenSim::AllPairsBodyKinematics());
+
     std::string model_name = "calibrated_gait2392_thelen2003muscle.osim";
     OpenSim::Model model = OpenSim::Model(model_name);
     model.initSystem();
@@ -81,20 +176,30 @@ int main()
     i = 0;
     int j = 0;
     const auto bodies = model.getComponentList<OpenSim::Body>();
-    for (auto& root : bodies) {
-        const std::string& root_name = root.getName();
-        std::cout << "frame[" << ++i << "] is " << root_name
-            << " of type " << typeid(root).name() << std::endl;
-        for (auto& sub_component: bodies) {
-            const std::string& sub_component_name = sub_component.getName();
-            std::cout << "frame[" << ++j << "] is " << sub_component_name
-                << " of type " << typeid(sub_component).name() << std::endl;
-            // Create point kinematics reporter
-            OpenSim::PointKinematics pointKin;
-            pointKin.setPointName(root_name + "-" + sub_component_name);
-            pointKin.setBody(&root);
-            pointKin.setRelativeToBody(&sub_component);
-            analyzeIMU.updAnalysisSet().cloneAndAppend(pointKin);
+    std::vector<std::string> bodyNames;
+    for (auto& body : bodies) {
+        bodyNames.push_back(body.getName());
+    }
+    if (allPairs) {
+        // Positions are realized once per frame for every pair
+        OpenSim::AllPairsBodyKinematics allPairsKin;
+        analyzeIMU.updAnalysisSet().cloneAndAppend(allPairsKin);
+    } else {
+        for (auto& root : bodies) {
+            const std::string& root_name = root.getName();
+            std::cout << "frame[" << ++i << "] is " << root_name
+                << " of type " << typeid(root).name() << std::endl;
+            for (auto& sub_component: bodies) {
+                const std::string& sub_component_name = sub_component.getName();
+                std::cout << "frame[" << ++j << "] is " << sub_component_name
+                    << " of type " << typeid(sub_component).name() << std::endl;
+                // Create point kinematics reporter
+                OpenSim::PointKinematics pointKin;
+                pointKin.setPointName(root_name + "-" + sub_component_name);
+                pointKin.setBody(&root);
+                pointKin.setRelativeToBody(&sub_component);
+                analyzeIMU.updAnalysisSet().cloneAndAppend(pointKin);
+            }
         }
     }
 
@@ -107,6 +212,36 @@ int main()
 
     std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
     std::cout << "Runtime = " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << "[µs]" << std::endl;
+    std::cout << "Peak memory (VmHWM) = " << peakMemoryKB() << "[kB] with "
+              << (allPairs ? "AllPairsBodyKinematics" : "PointKinematics per pair")
+              << std::endl;
+
+    if (frameParallel) {
+        const std::string parallelDir = "results_frame_parallel";
+        std::chrono::steady_clock::time_point parallelBegin = std::chrono::steady_clock::now();
+        const int chunks = runFrameParallel(output_file_name,
+                std::thread::hardware_concurrency(), parallelDir);
+        std::chrono::steady_clock::time_point parallelEnd = std::chrono::steady_clock::now();
+        std::cout << "Frame parallel runtime = " << std::chrono::duration_cast<std::chrono::microseconds>(parallelEnd - parallelBegin).count()
+                  << "[µs] with " << chunks << " chunks" << std::endl;
+        if (countDifferingFiles(parallelDir, "results") != 0) {
+            return 1;
+        }
+    }
+
+    if (allPairs) {
+        const double diff = compareWithPointKinematics(
+                "results/test_distance_analysis_AllPairsBodyKinematics" + columnarExtension,
+                "results/test_distance_analysis_PointKinematics_", bodyNames);
+        if (diff < 0) {
+            std::cout << "No PointKinematics results to compare, run without --all-pairs first" << std::endl;
+        } else {
+            std::cout << "Max difference to PointKinematics = " << diff << std::endl;
+            if (diff > 1e-9) {
+                return 1;
+            }
+        }
+    }
     std::cout << "Finished Running without Error!" << std::endl;
     return 0;
 }
@@ -0,0 +1,155 @@
+#ifndef OPENSIM_SYNTHETIC_IMU_H_
+#define OPENSIM_SYNTHETIC_IMU_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  SyntheticIMU.h                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Common/STOFileAdapter.h>
+#include <OpenSim/Common/TimeSeriesTable.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/OpenSense/IMU.h>
+
+#include "CoordinateSplineCache.h"
+
+#include <string>
+#include <vector>
+
+// What IMUDataReporter reports for every IMU of the model, in one pass
+struct SyntheticIMUTables {
+  OpenSim::TimeSeriesTable_<SimTK::Quaternion> orientations;
+  OpenSim::TimeSeriesTableVec3 angularVelocity;
+  OpenSim::TimeSeriesTableVec3 linearAccelerations;
+};
+
+// Poses `model` frame by frame from `kin` and computes each IMU frame's
+// orientation in ground, angular velocity and accelerometer signal (origin
+// acceleration minus gravity), both expressed in the IMU frame. Accelerations
+// come from calcBodyAccelerationFromUDot with the spline qddot, i.e. without
+// forces, like IMUDataReporter with compute_accelerations_without_forces.
+// `s` must be a state of `model` (initSystem() already called).
+inline SyntheticIMUTables synthesizeIMUs(const OpenSim::Model &model,
+                                         SimTK::State &s,
+                                         const CoordinateKinematics &kin) {
+  const SimTK::SimbodyMatterSubsystem &matter = model.getMatterSubsystem();
+  const OpenSim::CoordinateSet &coordinateSet = model.getCoordinateSet();
+
+  // Coordinate columns to their mobilizers. As in Coordinate::setSpeedValue,
+  // a coordinate's u is the mobility of its mobilizer with the same index as
+  // its q, so mobilizers whose q and u do not line up (quaternions) are
+  // rejected.
+  std::vector<const OpenSim::Coordinate *> coordinates;
+  std::vector<const SimTK::MobilizedBody *> mobods;
+  for (const std::string &name : kin.coordinates) {
+    const OpenSim::Coordinate &coordinate = coordinateSet.get(name);
+    const SimTK::MobilizedBody &mobod =
+        matter.getMobilizedBody(coordinate.getBodyIndex());
+    OPENSIM_THROW_IF(mobod.getNumQ(s) != mobod.getNumU(s), OpenSim::Exception,
+                     "Coordinate " + name +
+                         " is on a mobilizer with more qs than us");
+    coordinates.push_back(&coordinate);
+    mobods.push_back(&mobod);
+  }
+  const SimTK::MultibodySystem &system = model.getMultibodySystem();
+  const bool constrained = matter.getNumConstraints() > 0;
+  const double accuracy = model.get_assembly_accuracy();
+
+  std::vector<const OpenSim::PhysicalFrame *> frames;
+  std::vector<std::string> labels;
+  for (const OpenSim::IMU &imu : model.getComponentList<OpenSim::IMU>()) {
+    frames.push_back(&imu.getConnectee<OpenSim::PhysicalFrame>("frame"));
+    labels.push_back(imu.getName());
+  }
+  const std::size_t nImus = frames.size();
+
+  SyntheticIMUTables tables;
+  tables.orientations.setColumnLabels(labels);
+  tables.angularVelocity.setColumnLabels(labels);
+  tables.linearAccelerations.setColumnLabels(labels);
+
+  const SimTK::Vec3 gravity = model.getGravity();
+  SimTK::Vector udot(s.getNU(), 0.0);
+  SimTK::Vector_<SimTK::SpatialVec> A_GB;
+  SimTK::RowVector_<SimTK::Quaternion> orientationRow(static_cast<int>(nImus));
+  SimTK::RowVector_<SimTK::Vec3> gyroRow(static_cast<int>(nImus));
+  SimTK::RowVector_<SimTK::Vec3> accRow(static_cast<int>(nImus));
+  for (std::size_t r = 0; r < kin.times.size(); ++r) {
+    const int row = static_cast<int>(r);
+    s.updTime() = kin.times[r];
+    for (std::size_t c = 0; c < coordinates.size(); ++c) {
+      coordinates[c]->setValue(s, kin.q(row, static_cast<int>(c)), false);
+    }
+    // Dependent coordinates follow the ones in the file, as with assemble()
+    if (constrained) {
+      system.projectQ(s, accuracy);
+    }
+    for (std::size_t c = 0; c < coordinates.size(); ++c) {
+      const int col = static_cast<int>(c);
+      coordinates[c]->setSpeedValue(s, kin.qdot(row, col));
+      mobods[c]->updOneFromUPartition(
+          s, coordinates[c]->getMobilizerQIndex(), udot) =
+          kin.qddot(row, col);
+    }
+    if (constrained) {
+      system.projectU(s, accuracy);
+    }
+    system.realize(s, SimTK::Stage::Velocity);
+    matter.calcBodyAccelerationFromUDot(s, udot, A_GB);
+
+    for (std::size_t i = 0; i < nImus; ++i) {
+      const OpenSim::PhysicalFrame &frame = *frames[i];
+      const SimTK::Rotation R_GF = frame.getTransformInGround(s).R();
+      orientationRow[static_cast<int>(i)] =
+          R_GF.convertRotationToQuaternion();
+      gyroRow[static_cast<int>(i)] =
+          ~R_GF * frame.getAngularVelocityInGround(s);
+
+      // Acceleration of the frame origin, a station on its base body
+      const SimTK::SpatialVec &A = A_GB[frame.getMobilizedBodyIndex()];
+      const SimTK::Vec3 &w = frame.getMobilizedBody()
+                                 .getBodyVelocity(s)[0];
+      const SimTK::Vec3 r_BF_G =
+          frame.getMobilizedBody().getBodyRotation(s) *
+          frame.findTransformInBaseFrame().p();
+      const SimTK::Vec3 a = A[1] + A[0] % r_BF_G + w % (w % r_BF_G);
+      accRow[static_cast<int>(i)] = ~R_GF * (a - gravity);
+    }
+    tables.orientations.appendRow(kin.times[r], orientationRow);
+    tables.angularVelocity.appendRow(kin.times[r], gyroRow);
+    tables.linearAccelerations.appendRow(kin.times[r], accRow);
+  }
+  return tables;
+}
+
+// File names follow IMUDataReporter: <prefix>_orientations.sto,
+// <prefix>_angular_velocity.sto and <prefix>_linear_accelerations.sto
+inline void writeSyntheticIMUs(const SyntheticIMUTables &tables,
+                               const std::string &prefix) {
+  OpenSim::STOFileAdapter_<SimTK::Quaternion>::write(
+      tables.orientations, prefix + "_orientations.sto");
+  OpenSim::STOFileAdapterVec3::write(tables.angularVelocity,
+                                     prefix + "_angular_velocity.sto");
+  OpenSim::STOFileAdapterVec3::write(tables.linearAccelerations,
+                                     prefix + "_linear_accelerations.sto");
+}
+
+#endif // OPENSIM_SYNTHETIC_IMU_H_
@@ -0,0 +1,313 @@
+/* -------------------------------------------------------------------------- *
+ *                            OpenSim:  main.cpp                              *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Analyses/IMUDataReporter.h>
+#include <OpenSim/Common/IO.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Tools/AnalyzeTool.h>
+
+// Thread Pool
+#include "BS_thread_pool.hpp" // BS::synced_stream, BS::thread_pool
+#include "SyntheticIMU.h"
+
+#include <algorithm>
+#include <chrono> // for std::chrono functions
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Synthetic accelerometer, gyro and orientation signals for every IMU of one
+// model from many coordinate (.mot) files. The model is parsed once; every
+// pool thread clones it once and reuses its clone and state for all the
+// trials it runs.
+
+// Logging output
+const int64_t time_now =
+    std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch())
+        .count();
+std::ofstream log_file("task-" + std::to_string(time_now) + ".log");
+BS::synced_stream sync_out(std::cout, log_file);
+
+const std::string coordinatesExtension = ".mot";
+const std::string sep = "_";
+
+std::mutex cloneMutex;
+thread_local std::unique_ptr<OpenSim::Model> workerModel;
+// State of workerModel right after initSystem(), restored before each trial
+thread_local std::unique_ptr<SimTK::State> workerDefaultState;
+
+// This thread's copy of the shared model, initialized on first use
+OpenSim::Model &threadModel(const OpenSim::Model &shared) {
+  if (!workerModel) {
+    {
+      std::lock_guard<std::mutex> lock(cloneMutex);
+      workerModel.reset(shared.clone());
+    }
+    workerDefaultState =
+        std::make_unique<SimTK::State>(workerModel->initSystem());
+  }
+  return *workerModel;
+}
+
+void process(const std::filesystem::path &file,
+             const std::filesystem::path &resultDir,
+             const OpenSim::Model &sharedModel,
+             CoordinateSplineCache &splineCache) {
+  sync_out.println("---Starting Synthetic IMU Processing: ", file.string());
+  try {
+    OpenSim::Model &model = threadModel(sharedModel);
+    // Coordinates missing from this trial keep their defaults rather than
+    // the previous trial's q and u on this thread
+    SimTK::State &s = model.updWorkingState();
+    s = *workerDefaultState;
+
+    const CoordinateKinematics kin = splineCache.get(model, file.string());
+    const SyntheticIMUTables tables = synthesizeIMUs(model, s, kin);
+
+    std::filesystem::create_directories(resultDir);
+    writeSyntheticIMUs(tables, (resultDir / file.stem()).string());
+    sync_out.println("Frames: ", kin.times.size(),
+                     " IMUs: ", tables.orientations.getNumColumns());
+  } catch (const std::exception &e) {
+    // Catching standard exceptions
+    sync_out.println("Error in processing: ", e.what());
+  } catch (...) {
+    sync_out.println("Error in processing File: ", file.string());
+  }
+  sync_out.println("-------Finished Result Dir: ", resultDir.string(),
+                   " File: ", file.stem().string());
+}
+
+void collectFiles(const std::filesystem::path &directory,
+                  std::vector<std::filesystem::path> &files) {
+  for (const auto &entry :
+       std::filesystem::recursive_directory_iterator(directory)) {
+    if (entry.is_regular_file() &&
+        entry.path().extension() == coordinatesExtension) {
+      files.push_back(entry.path());
+    }
+  }
+}
+
+// The file of `dir` whose name ends in `suffix`, empty if there is none
+std::string findResult(const std::filesystem::path &dir,
+                       const std::string &suffix) {
+  for (const auto &entry : std::filesystem::directory_iterator(dir)) {
+    const std::string name = entry.path().filename().string();
+    if (name.size() >= suffix.size() &&
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) ==
+            0) {
+      return entry.path().string();
+    }
+  }
+  return {};
+}
+
+// Largest element-wise difference of two tables, Infinity if their shapes
+// differ
+template <typename T, typename Distance>
+double maxDifference(const OpenSim::TimeSeriesTable_<T> &a,
+                     const OpenSim::TimeSeriesTable_<T> &b,
+                     Distance distance) {
+  if (a.getNumRows() != b.getNumRows() ||
+      a.getNumColumns() != b.getNumColumns()) {
+    return SimTK::Infinity;
+  }
+  double diff = 0;
+  for (int r = 0; r < static_cast<int>(a.getNumRows()); ++r) {
+    diff = std::max(diff, std::abs(a.getIndependentColumn()[r] -
+                                   b.getIndependentColumn()[r]));
+    for (int c = 0; c < static_cast<int>(a.getNumColumns()); ++c) {
+      diff = std::max(diff, distance(a.getMatrix()(r, c), b.getMatrix()(r, c)));
+    }
+  }
+  return diff;
+}
+
+// Synthesizes the bundled trial and runs it through an AnalyzeTool with
+// IMUDataReporter (compute_accelerations_without_forces); returns the largest
+// difference of the orientations, angular velocities and accelerations, or
+// -1 if a reporter output is missing
+double compareWithIMUDataReporter(const std::string &modelFile,
+                                  const std::string &coordinatesFile,
+                                  const std::string &resultsDir) {
+  OpenSim::Model model(modelFile);
+  SimTK::State &s = model.initSystem();
+  const SyntheticIMUTables synthetic = synthesizeIMUs(
+      model, s, computeCoordinateKinematics(model, coordinatesFile));
+
+  OpenSim::AnalyzeTool analyze;
+  analyze.setName("synthetic_imu_check");
+  analyze.setModelFilename(modelFile);
+  analyze.setCoordinatesFileName(coordinatesFile);
+  analyze.setLowpassCutoffFrequency(-1);
+  analyze.setInitialTime(synthetic.orientations.getIndependentColumn().front());
+  analyze.setFinalTime(synthetic.orientations.getIndependentColumn().back());
+  analyze.setResultsDir(resultsDir);
+  OpenSim::IMUDataReporter imuDataReporter;
+  imuDataReporter.setName("IMUDataReporter_no_forces");
+  imuDataReporter.set_compute_accelerations_without_forces(true);
+  analyze.updAnalysisSet().cloneAndAppend(imuDataReporter);
+  const std::string setupFile = "synthetic_imu_check.xml";
+  analyze.print(setupFile);
+  OpenSim::AnalyzeTool roundTrip(setupFile);
+  roundTrip.run();
+
+  const std::string orientationsFile =
+      findResult(resultsDir, "_orientations.sto");
+  const std::string angularVelocityFile =
+      findResult(resultsDir, "_angular_velocity.sto");
+  const std::string accelerationsFile =
+      findResult(resultsDir, "_linear_accelerations.sto");
+  if (orientationsFile.empty() || angularVelocityFile.empty() ||
+      accelerationsFile.empty()) {
+    return -1;
+  }
+  // q and -q are the same orientation
+  const auto quaternionDistance = [](const SimTK::Quaternion &a,
+                                     const SimTK::Quaternion &b) {
+    return std::min((a.asVec4() - b.asVec4()).normInf(),
+                    (a.asVec4() + b.asVec4()).normInf());
+  };
+  const auto vec3Distance = [](const SimTK::Vec3 &a, const SimTK::Vec3 &b) {
+    return (a - b).normInf();
+  };
+  return std::max(
+      {maxDifference(synthetic.orientations,
+                     OpenSim::TimeSeriesTable_<SimTK::Quaternion>(
+                         orientationsFile),
+                     quaternionDistance),
+       maxDifference(synthetic.angularVelocity,
+                     OpenSim::TimeSeriesTableVec3(angularVelocityFile),
+                     vec3Distance),
+       maxDifference(synthetic.linearAccelerations,
+                     OpenSim::TimeSeriesTableVec3(accelerationsFile),
+                     vec3Distance)});
+}
+
+int main(int argc, char *argv[]) {
+  std::chrono::steady_clock::time_point begin =
+      std::chrono::steady_clock::now();
+  // ./main --check compares the bundled trial with IMUDataReporter
+  if (argc == 2 && std::string(argv[1]) == "--check") {
+    const double diff = compareWithIMUDataReporter(
+        "calibrated_gait2392_thelen2003muscle.osim",
+        "ik_l_comf_01-000_orientations.mot", "results_check");
+    std::chrono::steady_clock::time_point end =
+        std::chrono::steady_clock::now();
+    sync_out.println(
+        "Runtime = ",
+        std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+            .count(),
+        " [µs]");
+    if (diff < 0) {
+      sync_out.println("IMUDataReporter results are missing");
+      return 1;
+    }
+    sync_out.println("Max difference to IMUDataReporter = ", diff);
+    if (diff > 1e-6) {
+      return 1;
+    }
+    sync_out.println("Finished Running without Error!");
+    return 0;
+  }
+  if (argc < 4) {
+    std::cerr << "Usage: " << argv[0]
+              << " <model_path> <directory_path> <output_path>"
+                 " [--spline-cache <directory>]\n"
+              << "       " << argv[0] << " --check" << std::endl;
+    return 1;
+  }
+
+  const std::filesystem::path modelPath = argv[1];
+  if (!std::filesystem::exists(modelPath)) {
+    std::cerr << "The provided model does not exist: " << modelPath
+              << std::endl;
+    return 1;
+  }
+  std::filesystem::path directoryPath = argv[2];
+  if (!std::filesystem::exists(directoryPath) ||
+      !std::filesystem::is_directory(directoryPath)) {
+    std::cerr << "The provided path is not a valid directory: "
+              << directoryPath << std::endl;
+    return 1;
+  }
+  std::filesystem::path outputPath = argv[3];
+  // Spline fits of the coordinate files, shareable with other tools and runs
+  std::filesystem::path splineCachePath =
+      outputPath / "coordinate_spline_cache";
+  for (int i = 4; i + 1 < argc; ++i) {
+    if (std::string(argv[i]) == "--spline-cache") {
+      splineCachePath = argv[++i];
+    }
+  }
+  CoordinateSplineCache splineCache(splineCachePath);
+
+  // Parsed once, cloned per thread
+  OpenSim::Model sharedModel(modelPath.string());
+  sharedModel.finalizeFromProperties();
+
+  // Threading
+  const int max_threads = 64;
+  const int num_threads = std::thread::hardware_concurrency() > max_threads
+                              ? max_threads
+                              : std::thread::hardware_concurrency();
+  BS::thread_pool pool(num_threads);
+  sync_out.println("Thread Pool num threads: ", pool.get_thread_count());
+
+  std::vector<std::filesystem::path> files;
+  collectFiles(directoryPath, files);
+  sync_out.println("Coordinate files: ", files.size());
+
+  OpenSim::IO::SetDigitsPad(4);
+  for (const auto &file : files) {
+    // Results mirror the input tree
+    const std::filesystem::path resultDir =
+        outputPath /
+        std::filesystem::relative(file.parent_path(), directoryPath);
+    pool.detach_task([file, resultDir, &sharedModel, &splineCache] {
+      process(file, resultDir, sharedModel, splineCache);
+    });
+  }
+  // Wait for all tasks to finish
+  pool.wait();
+  sync_out.println("Spline cache: ", splineCache.hits(), " hits, ",
+                   splineCache.misses(), " misses (", splineCachePath.string(),
+                   ")");
+
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  const double runtime =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+          .count();
+  sync_out.println("Runtime = ", runtime, " [µs]");
+  sync_out.println("Finished Running without Error!");
+  return 0;
+}
@@ -0,0 +1,604 @@
+#ifndef OPENSIM_XSENS_MAPPED_READER_H_
+#define OPENSIM_XSENS_MAPPED_READER_H_
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  XsensMappedReader.h                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Common/Exception.h>
+#include <OpenSim/Common/XsensDataReader.h>
+#include <OpenSim/Common/XsensDataReaderSettings.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Read-only memory mapping of a whole file.
+class MappedFile {
+public:
+  explicit MappedFile(const std::string &fileName) {
+    const int fd = ::open(fileName.c_str(), O_RDONLY);
+    OPENSIM_THROW_IF(fd < 0, OpenSim::Exception, "Could not open " + fileName);
+    struct stat st {};
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+      _size = size_t(st.st_size);
+      void *data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        _data = static_cast<const char *>(data);
+        ::madvise(data, _size, MADV_SEQUENTIAL);
+      }
+    }
+    ::close(fd);
+    OPENSIM_THROW_IF(_size > 0 && _data == nullptr, OpenSim::Exception,
+                     "Could not map " + fileName);
+  }
+  ~MappedFile() {
+    if (_data) {
+      ::munmap(const_cast<char *>(_data), _size);
+    }
+  }
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  std::string_view view() const { return {_data, _size}; }
+
+private:
+  const char *_data = nullptr;
+  size_t _size = 0;
+};
+
+// Column layout of a trial's Xsens exports. It is compiled once, from the `//`
+// header block and the column label line of the first sensor file, and then
+// reused for every sensor of the trial. Every field of a data row maps to a
+// value slot (-1 when the field is not needed), so rows are parsed without
+// looking at labels or branching on the rotation representation per cell.
+struct XsensColumnPlan {
+  enum Slot { Packet = 0, Acc = 1, Gyr = 4, Mag = 7, Rot = 10, NumSlots = 19 };
+
+  // Rotation columns of a row, resolved from `representation` once
+  enum class RotationFormat { Matrix, Quaternion, Euler };
+
+  char delimiter = '\t';
+  std::string representation; // rot_matrix, rot_quaternion or rot_euler
+  RotationFormat rotationFormat = RotationFormat::Matrix;
+  std::string labelLine;      // column labels the plan was compiled from
+  double dataRate = SimTK::NaN;
+  bool hasPacket = false;
+  bool hasAcc = false;
+  bool hasGyr = false;
+  bool hasMag = false;
+  bool hasRot = false;
+  std::vector<int> slotOfField; // up to the last field that is needed
+
+  // Consume the `//` header block and the column label line from `text`.
+  // Returns the label line; `dataRate` is set from "Update Rate:" if present.
+  static std::string_view readHeader(std::string_view &text,
+                                     double &dataRate) {
+    while (!text.empty()) {
+      const std::string_view line = nextLine(text);
+      if (line.rfind("//", 0) != 0) {
+        return line;
+      }
+      const size_t rate = line.find("Update Rate:");
+      if (rate != std::string_view::npos && SimTK::isNaN(dataRate)) {
+        // Always '.' decimals, whatever the global locale (std::stod would
+        // stop at the '.' under a comma-decimal locale)
+        const char *first = line.data() + rate + 12;
+        const char *last = line.data() + line.size();
+        while (first < last && (*first == ' ' || *first == '\t'))
+          ++first;
+        std::from_chars(first, last, dataRate);
+      }
+    }
+    return {};
+  }
+
+  // `preferredDelimiter` (from the reader settings) is used when it splits
+  // the label line; otherwise the delimiter is sniffed from the label line.
+  static XsensColumnPlan compile(std::string_view text, char preferredDelimiter,
+                                 const std::string &representation) {
+    XsensColumnPlan plan;
+    plan.representation = representation;
+    const std::string_view labels = readHeader(text, plan.dataRate);
+    plan.labelLine = std::string(labels);
+
+    plan.delimiter = preferredDelimiter;
+    if (labels.find(preferredDelimiter) == std::string_view::npos) {
+      size_t best = 0;
+      for (const char candidate : {'\t', ',', ';', ' '}) {
+        const size_t n = size_t(
+            std::count(labels.begin(), labels.end(), candidate));
+        if (n > best) {
+          best = n;
+          plan.delimiter = candidate;
+        }
+      }
+    }
+
+    std::vector<std::string_view> fields;
+    size_t start = 0;
+    while (true) {
+      const size_t end = labels.find(plan.delimiter, start);
+      fields.push_back(labels.substr(start, end - start));
+      if (end == std::string_view::npos) {
+        break;
+      }
+      start = end + 1;
+    }
+    const auto column = [&](std::string_view name) {
+      const auto it = std::find(fields.begin(), fields.end(), name);
+      return it == fields.end() ? -1 : int(it - fields.begin());
+    };
+    const auto map = [&](int field, int slot, int width) {
+      if (field < 0) {
+        return false;
+      }
+      if (int(plan.slotOfField.size()) < field + width) {
+        plan.slotOfField.resize(field + width, -1);
+      }
+      for (int k = 0; k < width; ++k) {
+        plan.slotOfField[field + k] = slot + k;
+      }
+      return true;
+    };
+    plan.hasPacket = map(column("PacketCounter"), Packet, 1);
+    plan.hasAcc = map(column("Acc_X"), Acc, 3);
+    plan.hasGyr = map(column("Gyr_X"), Gyr, 3);
+    plan.hasMag = map(column("Mag_X"), Mag, 3);
+    if (representation == "rot_quaternion") {
+      plan.rotationFormat = RotationFormat::Quaternion;
+      plan.hasRot = map(column("Quat_q0"), Rot, 4);
+    } else if (representation == "rot_euler") {
+      plan.rotationFormat = RotationFormat::Euler;
+      plan.hasRot = map(column("Roll"), Rot, 3);
+    } else {
+      plan.rotationFormat = RotationFormat::Matrix;
+      plan.hasRot = map(column("Mat[1][1]"), Rot, 9);
+    }
+    return plan;
+  }
+
+  static std::string_view nextLine(std::string_view &text) {
+    const size_t end = text.find('\n');
+    std::string_view line = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    return line;
+  }
+};
+
+// Drop-in alternative to XsensDataReader::read(). Every sensor file of the
+// trial is memory mapped and parsed on its own thread, then the sensors are
+// aligned on PacketCounter into preallocated matrices. Values, times and the
+// DataRate metadata are produced the same way as XsensDataReader (rotation
+// conversion goes through the same SimTK calls, times are accumulated from
+// 0 with 1 / DataRate, DataRate falls back to 40 Hz when the header has no
+// Update Rate), so the output tables are identical for files whose packet
+// counters line up. Samples missing from one sensor (dropped packets) are NaN
+// instead of shifting the rest of that sensor's data. Without a PacketCounter
+// column rows are matched by line, as XsensDataReader does.
+class XsensMappedReader {
+public:
+  explicit XsensMappedReader(const OpenSim::XsensDataReaderSettings &settings)
+      : _settings(settings) {}
+
+  OpenSim::DataAdapter::OutputTables read(const std::string &folder) const {
+    const int numSensors = _settings.getProperty_ExperimentalSensors().size();
+    const std::string delimiter = _settings.get_delimiter();
+    const char delim = delimiter.empty() ? '\t' : delimiter[0];
+
+    std::vector<std::string> labels;
+    std::vector<std::unique_ptr<MappedFile>> files;
+    for (int s = 0; s < numSensors; ++s) {
+      const auto &sensor = _settings.get_ExperimentalSensors(s);
+      labels.push_back(sensor.get_name_in_model());
+      const std::filesystem::path fileName =
+          std::filesystem::path(folder) /
+          (_settings.get_trial_prefix() + sensor.getName() + ".txt");
+      files.push_back(std::make_unique<MappedFile>(fileName.string()));
+    }
+
+    // One column plan for the whole trial
+    const XsensColumnPlan plan =
+        numSensors > 0
+            ? XsensColumnPlan::compile(files[0]->view(), delim,
+                                       _settings.get_rotation_representation())
+            : XsensColumnPlan{};
+
+    std::vector<std::future<SensorData>> parsed;
+    for (int s = 0; s < numSensors; ++s) {
+      parsed.push_back(std::async(std::launch::async, [&, s] {
+        return parseSensor(files[s]->view(), plan);
+      }));
+    }
+    std::vector<SensorData> sensors;
+    for (auto &p : parsed) {
+      sensors.push_back(p.get());
+    }
+
+    // Row of every sample of every sensor in the output tables
+    size_t numRows = 0;
+    std::vector<std::vector<int64_t>> rowOf(numSensors);
+    alignSensors(sensors, rowOf, numRows);
+
+    double dataRate = 40.0;
+    for (const auto &sensor : sensors) {
+      if (!SimTK::isNaN(sensor.dataRate)) {
+        dataRate = sensor.dataRate;
+        break;
+      }
+    }
+    const double timeIncrement = 1.0 / dataRate;
+    std::vector<double> times(numRows);
+    double time = 0.0;
+    for (size_t i = 0; i < numRows; ++i) {
+      times[i] = time;
+      time += timeIncrement;
+    }
+
+    const int nr = static_cast<int>(numRows);
+    SimTK::Matrix_<SimTK::Quaternion> rotations(nr, numSensors);
+    SimTK::Matrix_<SimTK::Vec3> accelerations(nr, numSensors);
+    SimTK::Matrix_<SimTK::Vec3> angularVelocities(nr, numSensors);
+    SimTK::Matrix_<SimTK::Vec3> magneticHeadings(nr, numSensors);
+    rotations.setToNaN();
+    accelerations.setToNaN();
+    angularVelocities.setToNaN();
+    magneticHeadings.setToNaN();
+    for (int s = 0; s < numSensors; ++s) {
+      const SensorData &sensor = sensors[s];
+      for (size_t k = 0; k < rowOf[s].size(); ++k) {
+        const int64_t row = rowOf[s][k];
+        if (row < 0 || row >= nr) {
+          continue;
+        }
+        const int i = static_cast<int>(row);
+        if (!sensor.rotations.empty())
+          rotations(i, s) = sensor.rotations[k];
+        if (!sensor.accelerations.empty())
+          accelerations(i, s) = sensor.accelerations[k];
+        if (!sensor.angularVelocities.empty())
+          angularVelocities(i, s) = sensor.angularVelocities[k];
+        if (!sensor.magneticHeadings.empty())
+          magneticHeadings(i, s) = sensor.magneticHeadings[k];
+      }
+    }
+
+    OpenSim::DataAdapter::OutputTables tables{};
+    const std::string rate = std::to_string(dataRate);
+    auto add = [&](const std::string &key, auto table) {
+      table->updTableMetaData().setValueForKey("DataRate", rate);
+      tables.emplace(key, table);
+    };
+    add(OpenSim::XsensDataReader::Orientations,
+        std::make_shared<OpenSim::TimeSeriesTableQuaternion>(times, rotations,
+                                                             labels));
+    add(OpenSim::XsensDataReader::LinearAccelerations,
+        std::make_shared<OpenSim::TimeSeriesTableVec3>(times, accelerations,
+                                                       labels));
+    add(OpenSim::XsensDataReader::MagneticHeading,
+        std::make_shared<OpenSim::TimeSeriesTableVec3>(times, magneticHeadings,
+                                                       labels));
+    add(OpenSim::XsensDataReader::AngularVelocity,
+        std::make_shared<OpenSim::TimeSeriesTableVec3>(
+            times, angularVelocities, labels));
+    return tables;
+  }
+
+private:
+  // Parsed samples of one sensor file, in file order. Vectors of data the file
+  // does not contain are left empty.
+  struct SensorData {
+    double dataRate = SimTK::NaN;
+    std::vector<int64_t> packets; // unwrapped PacketCounter
+    std::vector<SimTK::Quaternion> rotations;
+    std::vector<SimTK::Vec3> accelerations;
+    std::vector<SimTK::Vec3> angularVelocities;
+    std::vector<SimTK::Vec3> magneticHeadings;
+  };
+
+  static double toDouble(const char *first, const char *last) {
+    while (first < last && *first == ' ')
+      ++first;
+    while (last > first && last[-1] == ' ')
+      --last;
+    if (first < last && *first == '+')
+      ++first;
+    double value = SimTK::NaN;
+    std::from_chars(first, last, value);
+    return value;
+  }
+
+  static SensorData parseSensor(std::string_view text,
+                                const XsensColumnPlan &trialPlan) {
+    SensorData data;
+    std::string_view body = text;
+    const std::string_view labels =
+        XsensColumnPlan::readHeader(body, data.dataRate);
+    // A sensor exported with different columns gets its own plan
+    const XsensColumnPlan plan =
+        labels == trialPlan.labelLine
+            ? trialPlan
+            : XsensColumnPlan::compile(text, trialPlan.delimiter,
+                                       trialPlan.representation);
+
+    // Rough row count from the file size to avoid regrowing the buffers
+    const size_t estimate = body.size() / std::max<size_t>(labels.size(), 1);
+    if (plan.hasPacket)
+      data.packets.reserve(estimate);
+    if (plan.hasAcc)
+      data.accelerations.reserve(estimate);
+    if (plan.hasGyr)
+      data.angularVelocities.reserve(estimate);
+    if (plan.hasMag)
+      data.magneticHeadings.reserve(estimate);
+    if (plan.hasRot)
+      data.rotations.reserve(estimate);
+
+    // 1-based file line of the first data row
+    const int64_t firstLine = std::count(text.data(), body.data(), '\n') + 1;
+    switch (plan.delimiter) {
+    case '\t':
+      parseRows<'\t'>(body, plan, data, firstLine);
+      break;
+    case ',':
+      parseRows<','>(body, plan, data, firstLine);
+      break;
+    case ';':
+      parseRows<';'>(body, plan, data, firstLine);
+      break;
+    case ' ':
+      parseRows<' '>(body, plan, data, firstLine);
+      break;
+    default:
+      OPENSIM_THROW(OpenSim::Exception, "Unsupported delimiter in Xsens file");
+    }
+    return data;
+  }
+
+  // Data rows: fields are split on every delimiter (empty fields keep their
+  // position) and only the fields in the plan are converted. A row with too
+  // few fields or a malformed PacketCounter throws; `line` is the file line
+  // number of the first row, for the message.
+  template <char Delim>
+  static void parseRows(std::string_view body, const XsensColumnPlan &plan,
+                        SensorData &data, int64_t line) {
+    const int numFields = int(plan.slotOfField.size());
+    const int *slotOfField = plan.slotOfField.data();
+    double values[XsensColumnPlan::NumSlots];
+    int64_t previous = -1, wraps = 0;
+
+    const char *p = body.data();
+    const char *const end = p + body.size();
+    while (p < end) {
+      const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+      if (eol == nullptr) {
+        eol = end;
+      }
+      const char *lineEnd = (eol > p && eol[-1] == '\r') ? eol - 1 : eol;
+      if (lineEnd == p) {
+        p = eol + 1;
+        ++line;
+        continue;
+      }
+
+      int64_t packet = -1;
+      int field = 0;
+      for (const char *f = p; field < numFields; ++field) {
+        const char *fieldEnd =
+            static_cast<const char *>(std::memchr(f, Delim, lineEnd - f));
+        if (fieldEnd == nullptr) {
+          fieldEnd = lineEnd;
+        }
+        const int slot = slotOfField[field];
+        if (slot == XsensColumnPlan::Packet) {
+          const auto [ptr, ec] = std::from_chars(f, fieldEnd, packet);
+          OPENSIM_THROW_IF(ec != std::errc() || packet < 0,
+                           OpenSim::Exception,
+                           "Malformed PacketCounter on line " +
+                               std::to_string(line) + " of Xsens file");
+        } else if (slot > 0) {
+          values[slot] = toDouble(f, fieldEnd);
+        }
+        if (fieldEnd == lineEnd) {
+          ++field;
+          break;
+        }
+        f = fieldEnd + 1;
+      }
+      OPENSIM_THROW_IF(field < numFields, OpenSim::Exception,
+                       "Line " + std::to_string(line) + " of Xsens file has " +
+                           std::to_string(field) + " fields, expected at least " +
+                           std::to_string(numFields));
+
+      if (plan.hasPacket) {
+        // PacketCounter is 16 bit and wraps around
+        if (previous >= 0 && packet + 32768 < previous) {
+          ++wraps;
+        }
+        previous = packet;
+        data.packets.push_back(packet + wraps * 65536);
+      }
+      const double *v = values;
+      if (plan.hasAcc)
+        data.accelerations.emplace_back(v[XsensColumnPlan::Acc],
+                                        v[XsensColumnPlan::Acc + 1],
+                                        v[XsensColumnPlan::Acc + 2]);
+      if (plan.hasGyr)
+        data.angularVelocities.emplace_back(v[XsensColumnPlan::Gyr],
+                                            v[XsensColumnPlan::Gyr + 1],
+                                            v[XsensColumnPlan::Gyr + 2]);
+      if (plan.hasMag)
+        data.magneticHeadings.emplace_back(v[XsensColumnPlan::Mag],
+                                           v[XsensColumnPlan::Mag + 1],
+                                           v[XsensColumnPlan::Mag + 2]);
+      if (plan.hasRot)
+        data.rotations.push_back(
+            toQuaternion(v + XsensColumnPlan::Rot, plan.rotationFormat));
+      p = eol + 1;
+      ++line;
+    }
+  }
+
+  // Same conversions as XsensDataReader for each rotation representation.
+  static SimTK::Quaternion
+  toQuaternion(const double *v, XsensColumnPlan::RotationFormat format) {
+    if (format == XsensColumnPlan::RotationFormat::Quaternion) {
+      return SimTK::Quaternion(v[0], v[1], v[2], v[3]);
+    }
+    if (format == XsensColumnPlan::RotationFormat::Euler) {
+      const SimTK::Rotation rotation(
+          SimTK::BodyOrSpaceType::SpaceRotationSequence,
+          SimTK::convertDegreesToRadians(v[0]), SimTK::XAxis,
+          SimTK::convertDegreesToRadians(v[1]), SimTK::YAxis,
+          SimTK::convertDegreesToRadians(v[2]), SimTK::ZAxis);
+      return rotation.convertRotationToQuaternion();
+    }
+    // Mat[row][col] columns are stored column by column
+    SimTK::Mat33 matrix{SimTK::NaN};
+    int entry = 0;
+    for (int col = 0; col < 3; ++col) {
+      for (int row = 0; row < 3; ++row) {
+        matrix[row][col] = v[entry++];
+      }
+    }
+    const SimTK::Rotation rotation{matrix};
+    return rotation.convertRotationToQuaternion();
+  }
+
+  // Map every sample to an output row. The first sensor's first packet is
+  // row 0 and the table ends at the earliest last packet of all sensors.
+  static void alignSensors(const std::vector<SensorData> &sensors,
+                           std::vector<std::vector<int64_t>> &rowOf,
+                           size_t &numRows) {
+    const auto samples = [](const SensorData &s) {
+      return std::max({s.packets.size(), s.rotations.size(),
+                       s.accelerations.size(), s.angularVelocities.size(),
+                       s.magneticHeadings.size()});
+    };
+    bool havePackets = !sensors.empty();
+    for (const auto &sensor : sensors) {
+      havePackets = havePackets && !sensor.packets.empty();
+    }
+
+    if (!havePackets) {
+      // Match rows by line and stop at the shortest file
+      numRows = sensors.empty() ? 0 : samples(sensors[0]);
+      for (const auto &sensor : sensors) {
+        numRows = std::min(numRows, samples(sensor));
+      }
+      for (size_t s = 0; s < sensors.size(); ++s) {
+        rowOf[s].resize(samples(sensors[s]));
+        for (size_t k = 0; k < rowOf[s].size(); ++k) {
+          rowOf[s][k] = int64_t(k);
+        }
+      }
+      return;
+    }
+
+    const int64_t start = sensors[0].packets.front();
+    int64_t end = std::numeric_limits<int64_t>::max();
+    std::vector<int64_t> offsets(sensors.size(), 0);
+    for (size_t s = 0; s < sensors.size(); ++s) {
+      // Bring each sensor onto the first sensor's wrap count
+      int64_t delta = (sensors[s].packets.front() - start) % 65536;
+      if (delta >= 32768)
+        delta -= 65536;
+      if (delta < -32768)
+        delta += 65536;
+      offsets[s] = start + delta - sensors[s].packets.front();
+      end = std::min(end, sensors[s].packets.back() + offsets[s]);
+    }
+    numRows = end >= start ? size_t(end - start + 1) : 0;
+    for (size_t s = 0; s < sensors.size(); ++s) {
+      const auto &packets = sensors[s].packets;
+      rowOf[s].resize(packets.size());
+      for (size_t k = 0; k < packets.size(); ++k) {
+        rowOf[s][k] = packets[k] + offsets[s] - start;
+      }
+    }
+  }
+
+  const OpenSim::XsensDataReaderSettings _settings;
+};
+
+// True if both tables have the same labels and times and bitwise equal values
+// (NaN matches NaN). Used to check XsensMappedReader against XsensDataReader.
+template <typename ETY>
+bool tablesIdentical(const OpenSim::TimeSeriesTable_<ETY> &a,
+                     const OpenSim::TimeSeriesTable_<ETY> &b) {
+  if (a.getColumnLabels() != b.getColumnLabels() ||
+      a.getIndependentColumn() != b.getIndependentColumn()) {
+    return false;
+  }
+  const auto &ma = a.getMatrix();
+  const auto &mb = b.getMatrix();
+  for (int i = 0; i < ma.nrow(); ++i) {
+    for (int j = 0; j < ma.ncol(); ++j) {
+      for (int k = 0; k < ETY::size(); ++k) {
+        const double x = ma(i, j)[k], y = mb(i, j)[k];
+        if (x != y && !(SimTK::isNaN(x) && SimTK::isNaN(y))) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Compare the orientation, acceleration, gyro and magnetometer tables of two
+// reader outputs with tablesIdentical().
+inline bool
+outputTablesIdentical(const OpenSim::DataAdapter::OutputTables &a,
+                      const OpenSim::DataAdapter::OutputTables &b) {
+  using Quaternions = OpenSim::TimeSeriesTableQuaternion;
+  using Vec3s = OpenSim::TimeSeriesTableVec3;
+  const auto &quat = OpenSim::XsensDataReader::Orientations;
+  bool identical =
+      tablesIdentical(dynamic_cast<const Quaternions &>(*a.at(quat)),
+                      dynamic_cast<const Quaternions &>(*b.at(quat)));
+  for (const auto &key : {OpenSim::XsensDataReader::LinearAccelerations,
+                          OpenSim::XsensDataReader::AngularVelocity,
+                          OpenSim::XsensDataReader::MagneticHeading}) {
+    identical = identical &&
+                tablesIdentical(dynamic_cast<const Vec3s &>(*a.at(key)),
+                                dynamic_cast<const Vec3s &>(*b.at(key)));
+  }
+  return identical;
+}
+
+#endif // OPENSIM_XSENS_MAPPED_READER_H_
@@ -25,7 +25,10 @@
 #include <OpenSim/Common/XsensDataReader.h>
 #include <OpenSim/OpenSim.h>
 
+#include "XsensMappedReader.h"
+
 int main() {
+  bool mappedReaderMatches = true;
   const std::vector<std::pair<std::string, std::string>> settings_files = {
       {"myIMUMappings.xml", "_all"},
       {"myIMUMappings_pelvis_calcn.xml", "_pelvis_calcn"},
@@ -38,6 +41,12 @@ int main() {
     OpenSim::DataAdapter::OutputTables tables = reader.read(folder);
 
     const std::string &imu_desc = p.second;
+    // The memory-mapped reader must reproduce XsensDataReader exactly
+    const bool identical = outputTablesIdentical(
+        tables, XsensMappedReader(readerSettings).read(folder));
+    std::cout << "XsensMappedReader " << (identical ? "matches" : "DIFFERS")
+              << " for " << imu_desc << std::endl;
+    mappedReaderMatches = mappedReaderMatches && identical;
     // Magnetometer
     const OpenSim::TimeSeriesTableVec3 &magTableTyped =
         reader.getMagneticHeadingTable(tables);
@@ -81,5 +90,5 @@ int main() {
     accelTableTyped,
     "./ALEX_TEST_accelerations.sto");
 
-  return 0;
+  return mappedReaderMatches ? 0 : 1;
 }
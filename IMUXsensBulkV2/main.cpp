@@ -30,9 +30,12 @@
 #include <OpenSim/Common/XsensDataReader.h>
 #include <OpenSim/Common/XsensDataReaderSettings.h>
 
+#include "XsensMappedReader.h"
+
 #include <chrono> // for std::chrono functions
 #include <filesystem>
 #include <iostream>
+#include <set>
 #include <string>
 #include <thread>
 
@@ -57,7 +60,8 @@ const std::vector<OpenSim::ExperimentalSensor> expSensRemaining = {
 
 void process(
     const fs::path &file, const std::string &trial_prefix,
-    const std::vector<OpenSim::ExperimentalSensor> &experimentalSensors) {
+    const std::vector<OpenSim::ExperimentalSensor> &experimentalSensors,
+    bool useMappedReader) {
   std::cout << "---Starting Processing: " << file << std::endl;
   try {
     // Xsense Reader Settings
@@ -71,7 +75,9 @@ void process(
     std::string folder = settings.get_data_folder();
     std::cout << "Reading folder: " << folder
               << " Reading trial prefix: " << trial_prefix << std::endl;
-    OpenSim::DataAdapter::OutputTables tables = reader.read(folder);
+    OpenSim::DataAdapter::OutputTables tables =
+        useMappedReader ? XsensMappedReader(settings).read(folder)
+                        : reader.read(folder);
 
     const std::string base_filename =
         file.string() + settings.get_trial_prefix();
@@ -103,14 +109,17 @@ void process(
   std::cout << "---Ending Processing: " << file << std::endl;
 }
 
-void processDirectory(const fs::path &dirPath, const fs::path &resultPath) {
+void processDirectory(const fs::path &dirPath, const fs::path &resultPath,
+                      bool useMappedReader) {
 
   std::vector<std::thread> threads;
+  // Every sensor file of a trial shares the prefix; read each trial once
+  std::set<std::string> startedTrials;
   // Iterate through the directory
   for (const auto &entry : fs::directory_iterator(dirPath)) {
     if (entry.is_directory()) {
       // Recursively process subdirectory
-      processDirectory(entry.path(), resultPath);
+      processDirectory(entry.path(), resultPath, useMappedReader);
     } else if (entry.is_regular_file()) {
       // Check if the file has a .mat extension
       if (entry.path().extension() == ".txt") {
@@ -135,7 +144,10 @@ void processDirectory(const fs::path &dirPath, const fs::path &resultPath) {
           std::string prefix =
               (pos != std::string::npos) ? stem.substr(0, pos) : stem;
 
-          threads.emplace_back(process, baseDir, prefix, expSensRemaining);
+          if (startedTrials.insert(prefix).second) {
+            threads.emplace_back(process, baseDir, prefix, expSensRemaining,
+                                 useMappedReader);
+          }
         }
       }
     }
@@ -151,11 +163,17 @@ void processDirectory(const fs::path &dirPath, const fs::path &resultPath) {
 int main(int argc, char *argv[]) {
   std::chrono::steady_clock::time_point begin =
       std::chrono::steady_clock::now();
-  if (argc < 3) {
-    std::cerr << "Usage: " << argv[0] << " <directory_path> <output_path>"
+  const bool validReader =
+      argc == 5 && std::string(argv[3]) == "--reader" &&
+      (std::string(argv[4]) == "xsens" || std::string(argv[4]) == "mmap");
+  if (argc != 3 && !validReader) {
+    std::cerr << "Usage: " << argv[0]
+              << " <directory_path> <output_path> [--reader xsens|mmap]"
               << std::endl;
     return 1;
   }
+  // mmap: XsensMappedReader, parses all sensors of a trial in parallel
+  const bool useMappedReader = argc == 5 && std::string(argv[4]) == "mmap";
 
   fs::path directoryPath = argv[1];
   if (!fs::exists(directoryPath) || !fs::is_directory(directoryPath)) {
@@ -165,7 +183,7 @@ int main(int argc, char *argv[]) {
 
   fs::path outputPath = argv[2];
 
-  processDirectory(directoryPath, outputPath);
+  processDirectory(directoryPath, outputPath, useMappedReader);
   std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
   std::cout << "Runtime = "
             << std::chrono::duration_cast<std::chrono::microseconds>(end -
@@ -24,11 +24,16 @@
 // INCLUDES
 #include <OpenSim/Common/XsensDataReader.h>
 #include <OpenSim/OpenSim.h>
+
+#include "XsensMappedReader.h"
+
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <vector>
 
 int main() {
+  bool mappedReaderMatches = true;
   const std::vector<std::pair<std::string, std::string>> settings_files = {
       {"myIMUMappings.xml", "tab"},
       {"myIMUMappings.xml", "comma"},
@@ -54,6 +59,32 @@ int main() {
     std::string folder = readerSettings.get_data_folder();
     OpenSim::DataAdapter::OutputTables tables = reader.read(folder);
 
+    // The memory-mapped reader must reproduce XsensDataReader exactly
+    const bool identical = outputTablesIdentical(
+        tables, XsensMappedReader(readerSettings).read(folder));
+    std::cout << "XsensMappedReader " << (identical ? "matches" : "DIFFERS")
+              << " for " << delim << std::endl;
+    mappedReaderMatches = mappedReaderMatches && identical;
+
+    // Benchmark both readers on this trial (5 sensor files)
+    const int repeats = 20;
+    auto timeReader = [&](auto &&read) {
+      const auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < repeats; ++i) {
+        read();
+      }
+      const auto end = std::chrono::steady_clock::now();
+      return std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+                 .count() /
+             repeats;
+    };
+    const auto xsensTime = timeReader([&] { reader.read(folder); });
+    const auto mappedTime =
+        timeReader([&] { XsensMappedReader(readerSettings).read(folder); });
+    std::cout << "XsensDataReader = " << xsensTime
+              << "[µs], XsensMappedReader = " << mappedTime << "[µs]"
+              << std::endl;
+
     // Magnetometer
     const OpenSim::TimeSeriesTableVec3 &magTableTyped =
         reader.getMagneticHeadingTable(tables);
@@ -77,5 +108,5 @@ int main() {
         quatTableTyped, trial_prefix + "_orientations.sto");
   }
 
-  return 0;
+  return mappedReaderMatches ? 0 : 1;
 }
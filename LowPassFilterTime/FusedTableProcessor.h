@@ -0,0 +1,185 @@
+#ifndef OPENSIM_FUSED_TABLE_PROCESSOR_H_
+#define OPENSIM_FUSED_TABLE_PROCESSOR_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  FusedTableProcessor.h                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/SimulationUtilities.h>
+
+#include "TabOpLowPassFilterSoA.h"
+#include "UniformTimeAxis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Fused execution of the column-wise part of a TableProcessor pipeline:
+//
+//   TableProcessor(file) | TabOpLowPassFilter(f) | TabOpUseAbsoluteStateNames()
+//   ...processAndConvertToRadians(model)
+//
+// becomes FusedTableProcessor(file).lowPassFilter(f).useAbsoluteStateNames()
+// .processAndConvertToRadians(model). Renaming and column selection only touch
+// the labels, and degrees-to-radians is a per-column scale folded into the
+// gather, so each block of columns is read from the loaded table once,
+// resampled/scaled/filtered in one padded scratch buffer and written straight
+// into the result. Nothing but the loaded table and the result is ever the
+// size of the table.
+class FusedTableProcessor {
+public:
+    // Columns processed together, one per SIMD lane in the filter
+    static constexpr int blockWidth = 8;
+
+    explicit FusedTableProcessor(std::string fileName)
+            : _fileName(std::move(fileName)) {}
+
+    FusedTableProcessor& lowPassFilter(double cutoffFrequency) {
+        _cutoffFrequency = cutoffFrequency;
+        return *this;
+    }
+    FusedTableProcessor& useAbsoluteStateNames() {
+        _absoluteStateNames = true;
+        return *this;
+    }
+    // Keeps only `labels` (as named in the file), in that order
+    FusedTableProcessor& selectColumns(std::vector<std::string> labels) {
+        _selectedLabels = std::move(labels);
+        return *this;
+    }
+
+    OpenSim::TimeSeriesTable processAndConvertToRadians(
+            const OpenSim::Model& model) const {
+        const OpenSim::TimeSeriesTable input(_fileName);
+        const std::vector<double>& time = input.getIndependentColumn();
+
+        // Labels: selection, then renaming
+        std::vector<int> columns;
+        if (_selectedLabels.empty()) {
+            columns.resize(input.getNumColumns());
+            std::iota(columns.begin(), columns.end(), 0);
+        } else {
+            for (const std::string& label : _selectedLabels) {
+                columns.push_back(static_cast<int>(input.getColumnIndex(label)));
+            }
+        }
+        std::vector<std::string> labels;
+        for (int c : columns) labels.push_back(input.getColumnLabel(c));
+        if (_absoluteStateNames) OpenSim::updateStateLabels40(model, labels);
+
+        // Unit conversion: rotational coordinates of a table in degrees
+        const bool inDegrees = input.hasTableMetaDataKey("inDegrees") &&
+                input.getTableMetaDataAsString("inDegrees") == "yes";
+        std::vector<double> scales(columns.size(), 1.0);
+        if (inDegrees) {
+            const std::map<std::string, const OpenSim::Coordinate*> coordinates =
+                    coordinatesByLabel(model);
+            for (std::size_t c = 0; c < labels.size(); ++c) {
+                const auto it = coordinates.find(labels[c]);
+                if (it != coordinates.end() &&
+                        it->second->getMotionType() ==
+                                OpenSim::Coordinate::Rotational) {
+                    scales[c] = SimTK_DEGREE_TO_RADIAN;
+                }
+            }
+        }
+
+        // Time grid: the file's own if uniform, else resampled at dtMin
+        const bool filter = _cutoffFrequency != -1;
+        OPENSIM_THROW_IF(filter && time.size() < 2, OpenSim::Exception,
+                         "Need at least two rows to filter.");
+        const std::optional<UniformTimeAxis<double>> axis =
+                detectUniformTimeAxis(time);
+        const bool resample = filter && !axis;
+        UniformTimeAxis<double> grid;
+        if (axis) {
+            grid = *axis;
+        } else if (resample) {
+            const double dtMin = minimumInterval(time);
+            OPENSIM_THROW_IF(dtMin < SimTK::Eps, OpenSim::Exception,
+                             "Table cannot be resampled.");
+            grid = {time.front(), dtMin,
+                    static_cast<std::size_t>(std::floor(
+                            (time.back() - time.front()) / dtMin + 1e-9)) + 1};
+        } else {
+            grid = {0, 0, time.size()};
+        }
+        const int nRows = static_cast<int>(grid.count);
+        const int nCols = static_cast<int>(columns.size());
+        const int pad = filter ? filterPadding(nRows) : 0;
+
+        OpenSim::TimeSeriesTable out(
+                resample || axis ? grid.materialize() : time,
+                SimTK::Matrix(nRows, nCols), labels);
+        out.updTableMetaData() = input.getTableMetaData();
+        if (inDegrees) {
+            out.updTableMetaData().setValueForKey("inDegrees", std::string("no"));
+        }
+
+        SignalBufferSoA buffer;
+        buffer.nRows = nRows + 2 * pad;
+        buffer.data.reserve(std::size_t(buffer.nRows) * blockWidth);
+        SimTK::Matrix& values = out.updMatrix();
+        for (int first = 0; first < nCols; first += blockWidth) {
+            const int width = std::min(blockWidth, nCols - first);
+            buffer.nCols = width;
+            buffer.data.resize(std::size_t(buffer.nRows) * width);
+            gatherColumns(input,
+                          std::vector<int>(columns.begin() + first,
+                                           columns.begin() + first + width),
+                          std::vector<double>(scales.begin() + first,
+                                              scales.begin() + first + width),
+                          grid, resample, pad, buffer);
+            if (filter) {
+                filterPaddedSoA(buffer, pad, grid.step, _cutoffFrequency);
+            }
+            scatterColumns(buffer, pad, first, values);
+        }
+        return out;
+    }
+
+private:
+    // Coordinates by name and by absolute value path (the labels
+    // TabOpUseAbsoluteStateNames produces)
+    static std::map<std::string, const OpenSim::Coordinate*> coordinatesByLabel(
+            const OpenSim::Model& model) {
+        std::map<std::string, const OpenSim::Coordinate*> coordinates;
+        for (const OpenSim::Coordinate& coordinate :
+                model.getComponentList<OpenSim::Coordinate>()) {
+            coordinates[coordinate.getName()] = &coordinate;
+            coordinates[coordinate.getAbsolutePathString() + "/value"] = &coordinate;
+        }
+        return coordinates;
+    }
+
+    std::string _fileName;
+    double _cutoffFrequency = -1;
+    bool _absoluteStateNames = false;
+    std::vector<std::string> _selectedLabels;
+};
+
+#endif // OPENSIM_FUSED_TABLE_PROCESSOR_H_
@@ -0,0 +1,287 @@
+#ifndef OPENSIM_TABOP_LOW_PASS_FILTER_SOA_H_
+#define OPENSIM_TABOP_LOW_PASS_FILTER_SOA_H_
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  TabOpLowPassFilterSoA.h                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Common/GCVSpline.h>
+#include <OpenSim/Simulation/TableProcessor.h>
+
+#include "UniformTimeAxis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Row-major (time-major) buffer of all columns: sample c of row r is at
+// data[r * nCols + c]. IIR filters are recursive in time, so the only
+// independent work at each step is across columns; with columns contiguous
+// the inner loop over columns maps onto SIMD lanes.
+struct SignalBufferSoA {
+    int nRows = 0;
+    int nCols = 0;
+    std::vector<double> data;
+
+    double* row(int r) { return data.data() + std::size_t(r) * nCols; }
+    const double* row(int r) const {
+        return data.data() + std::size_t(r) * nCols;
+    }
+};
+
+// 3rd-order Butterworth lowpass from the bilinear transform with prewarping,
+// as a first-order section followed by a biquad (Q = 1), in transposed direct
+// form II. The filter states are primed for a constant input equal to the
+// first sample, so a padded signal starts without a step.
+class ButterworthLowpass3SoA {
+public:
+    ButterworthLowpass3SoA(double dt, double cutoffFrequency) {
+        const double K = std::tan(SimTK::Pi * cutoffFrequency * dt);
+        // First order: H(s) = 1 / (s + 1)
+        _b10 = K / (1 + K);
+        _b11 = _b10;
+        _a11 = (K - 1) / (K + 1);
+        // Second order: H(s) = 1 / (s^2 + s + 1)
+        const double norm = 1 / (1 + K + K * K);
+        _b20 = K * K * norm;
+        _b21 = 2 * _b20;
+        _b22 = _b20;
+        _a21 = 2 * (K * K - 1) * norm;
+        _a22 = (1 - K + K * K) * norm;
+    }
+
+    // Filters rows [0, nRows) forward in place
+    void forward(SignalBufferSoA& buffer) const { run(buffer, false); }
+    // Filters rows backward in place (zero phase when combined with forward)
+    void backward(SignalBufferSoA& buffer) const { run(buffer, true); }
+
+private:
+    void run(SignalBufferSoA& buffer, bool reverse) const {
+        const int nCols = buffer.nCols;
+        const int nRows = buffer.nRows;
+        if (nRows == 0) return;
+        std::vector<double> s1(nCols), s2(nCols), s3(nCols);
+        const double* first = buffer.row(reverse ? nRows - 1 : 0);
+        for (int c = 0; c < nCols; ++c) {
+            s1[c] = (_b11 - _a11) * first[c];
+            s3[c] = (_b22 - _a22) * first[c];
+            s2[c] = (_b21 - _a21) * first[c] + s3[c];
+        }
+        const double b10 = _b10, b11 = _b11, a11 = _a11;
+        const double b20 = _b20, b21 = _b21, b22 = _b22;
+        const double a21 = _a21, a22 = _a22;
+        double* z1 = s1.data();
+        double* z2 = s2.data();
+        double* z3 = s3.data();
+        for (int i = 0; i < nRows; ++i) {
+            double* x = buffer.row(reverse ? nRows - 1 - i : i);
+            #pragma omp simd
+            for (int c = 0; c < nCols; ++c) {
+                const double u = b10 * x[c] + z1[c];
+                z1[c] = b11 * x[c] - a11 * u;
+                const double y = b20 * u + z2[c];
+                z2[c] = b21 * u - a21 * y + z3[c];
+                z3[c] = b22 * u - a22 * y;
+                x[c] = y;
+            }
+        }
+    }
+
+    double _b10, _b11, _a11;
+    double _b20, _b21, _b22, _a21, _a22;
+};
+
+// Rows of padding added on each side of an nRows signal: half its length, as
+// TableUtilities::filterLowpass pads
+inline int filterPadding(int nRows) { return std::min(nRows / 2, nRows - 1); }
+
+// Fills the first and last `pad` rows of `buffer` by odd reflection
+// (2 x0 - x[k]) of the signal held in between, the padding TableUtilities::pad
+// uses before filtering
+inline void padOddReflect(SignalBufferSoA& buffer, int pad) {
+    const int n = buffer.nRows - 2 * pad;
+    const double* first = buffer.row(pad);
+    const double* last = buffer.row(pad + n - 1);
+    for (int k = 1; k <= pad; ++k) {
+        const double* pre = buffer.row(pad + k);
+        const double* post = buffer.row(pad + n - 1 - k);
+        double* outPre = buffer.row(pad - k);
+        double* outPost = buffer.row(pad + n - 1 + k);
+        #pragma omp simd
+        for (int c = 0; c < buffer.nCols; ++c) {
+            outPre[c] = 2 * first[c] - pre[c];
+            outPost[c] = 2 * last[c] - post[c];
+        }
+    }
+}
+
+// Zero-phase lowpass of the signal between `pad` rows on each side of
+// `buffer`; left unfiltered if the cutoff is not below Nyquist
+inline void filterPaddedSoA(SignalBufferSoA& buffer, int pad, double dt,
+                            double cutoffFrequency) {
+    if (cutoffFrequency >= 0.5 / dt) return;
+    padOddReflect(buffer, pad);
+    const ButterworthLowpass3SoA filter(dt, cutoffFrequency);
+    filter.forward(buffer);
+    filter.backward(buffer);
+}
+
+// Copies `columns` of `table`, each multiplied by its entry in `scales`, into
+// lanes 0.. of `buffer` starting at row `pad`. With `resample` the columns are
+// evaluated on `grid` through interpolating GCV splines, built one column at a
+// time rather than as a GCVSplineSet of the whole table; otherwise the rows
+// are already `grid`.
+inline void gatherColumns(const OpenSim::TimeSeriesTable& table,
+                          const std::vector<int>& columns,
+                          const std::vector<double>& scales,
+                          const UniformTimeAxis<double>& grid, bool resample,
+                          int pad, SignalBufferSoA& buffer) {
+    const int nCols = static_cast<int>(columns.size());
+    const int nRows = static_cast<int>(grid.count);
+    const SimTK::Matrix& m = table.getMatrix();
+    if (resample) {
+        const std::vector<double>& time = table.getIndependentColumn();
+        std::vector<double> column(time.size());
+        SimTK::Vector t(1);
+        for (int c = 0; c < nCols; ++c) {
+            for (std::size_t r = 0; r < time.size(); ++r) {
+                column[r] = m(int(r), columns[c]);
+            }
+            const OpenSim::GCVSpline spline(5, static_cast<int>(time.size()),
+                                            time.data(), column.data());
+            for (int r = 0; r < nRows; ++r) {
+                t[0] = grid[r];
+                buffer.row(pad + r)[c] = scales[c] * spline.calcValue(t);
+            }
+        }
+    } else {
+        for (int r = 0; r < nRows; ++r) {
+            double* row = buffer.row(pad + r);
+            for (int c = 0; c < nCols; ++c) {
+                row[c] = scales[c] * m(r, columns[c]);
+            }
+        }
+    }
+}
+
+// Writes the signal rows of `buffer` into columns firstColumn.. of `m`
+inline void scatterColumns(const SignalBufferSoA& buffer, int pad,
+                           int firstColumn, SimTK::Matrix& m) {
+    const int nRows = buffer.nRows - 2 * pad;
+    for (int r = 0; r < nRows; ++r) {
+        const double* row = buffer.row(pad + r);
+        for (int c = 0; c < buffer.nCols; ++c) {
+            m(r, firstColumn + c) = row[c];
+        }
+    }
+}
+
+// Shortest sample interval, the grid TableUtilities::filterLowpass resamples
+// non-uniform tables onto
+inline double minimumInterval(const std::vector<double>& time) {
+    double dtMin = SimTK::Infinity;
+    for (std::size_t i = 1; i < time.size(); ++i) {
+        dtMin = std::min(dtMin, time[i] - time[i - 1]);
+    }
+    return dtMin;
+}
+
+// Lowpass filters every column of `table` with a zero-phase (forward and
+// backward) 3rd-order Butterworth at `cutoffFrequency` Hz. `axis` is the
+// table's uniform time axis if it has one (detected once at load); otherwise
+// the table is first resampled with interpolating GCV splines onto the exact
+// grid t0 + i * dtMin.
+inline void lowPassFilterSoA(OpenSim::TimeSeriesTable& table,
+                             double cutoffFrequency,
+                             const std::optional<UniformTimeAxis<double>>& axis) {
+    const std::vector<double>& time = table.getIndependentColumn();
+    const int nCols = static_cast<int>(table.getNumColumns());
+    OPENSIM_THROW_IF(time.size() < 2, OpenSim::Exception,
+                     "Need at least two rows to filter.");
+    const bool resample = !axis;
+    UniformTimeAxis<double> grid;
+    if (resample) {
+        const double dtMin = minimumInterval(time);
+        OPENSIM_THROW_IF(dtMin < SimTK::Eps, OpenSim::Exception,
+                         "Table cannot be resampled.");
+        grid = {time.front(), dtMin,
+                static_cast<std::size_t>(
+                        std::floor((time.back() - time.front()) / dtMin + 1e-9)) + 1};
+    } else {
+        grid = *axis;
+    }
+    const int nRows = static_cast<int>(grid.count);
+    const int pad = filterPadding(nRows);
+    SignalBufferSoA buffer;
+    buffer.nCols = nCols;
+    buffer.nRows = nRows + 2 * pad;
+    buffer.data.resize(std::size_t(buffer.nRows) * nCols);
+    std::vector<int> columns(nCols);
+    std::iota(columns.begin(), columns.end(), 0);
+    gatherColumns(table, columns, std::vector<double>(nCols, 1.0), grid,
+                  resample, pad, buffer);
+    filterPaddedSoA(buffer, pad, grid.step, cutoffFrequency);
+
+    OpenSim::TimeSeriesTable out(grid.materialize(), SimTK::Matrix(nRows, nCols),
+                                 table.getColumnLabels());
+    out.updTableMetaData() = table.getTableMetaData();
+    scatterColumns(buffer, pad, 0, out.updMatrix());
+    table = out;
+}
+
+inline void lowPassFilterSoA(OpenSim::TimeSeriesTable& table,
+                             double cutoffFrequency) {
+    lowPassFilterSoA(table, cutoffFrequency,
+                     detectUniformTimeAxis(table.getIndependentColumn()));
+}
+
+namespace OpenSim {
+
+/// Drop-in for TabOpLowPassFilter that filters all columns in one pass over
+/// a structure-of-arrays buffer (see lowPassFilterSoA()).
+class TabOpLowPassFilterSoA : public TableOperator {
+    OpenSim_DECLARE_CONCRETE_OBJECT(TabOpLowPassFilterSoA, TableOperator);
+
+public:
+    OpenSim_DECLARE_PROPERTY(cutoff_frequency, double,
+            "Low-pass cutoff frequency (Hz) (default is -1, which means no "
+            "filtering).");
+    TabOpLowPassFilterSoA() { constructProperty_cutoff_frequency(-1); }
+    TabOpLowPassFilterSoA(double cutoffFrequency) : TabOpLowPassFilterSoA() {
+        set_cutoff_frequency(cutoffFrequency);
+    }
+    void operate(TimeSeriesTable& table, const Model* = nullptr) const override {
+        if (get_cutoff_frequency() != -1) {
+            OPENSIM_THROW_IF(get_cutoff_frequency() <= 0, Exception,
+                    "Expected cutoff frequency to be positive, but got {}.",
+                    get_cutoff_frequency());
+            lowPassFilterSoA(table, get_cutoff_frequency());
+        }
+    }
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_TABOP_LOW_PASS_FILTER_SOA_H_
@@ -27,11 +27,173 @@
 #include <OpenSim/Simulation/TableProcessor.h>
 #include <OpenSim/Simulation/Model/Model.h>
 
+#include "FusedTableProcessor.h"
+#include "TabOpLowPassFilterSoA.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
 #include <string>
+#include <vector>
 #include <iostream>
 #include <clocale>
 #include <chrono> // for std::chrono functions
 
+// Mean runtime [µs] of `op` on a copy of `table` over `repeats` runs (file
+// parsing excluded)
+double timeFilter(const OpenSim::TimeSeriesTable& table,
+                  const OpenSim::TableOperator& op, int repeats,
+                  OpenSim::TimeSeriesTable& result)
+{
+    double total = 0;
+    for (int i = 0; i < repeats; ++i) {
+        result = table;
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        op.operate(result);
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        total += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    }
+    return total / repeats;
+}
+
+// Largest deviation of the time column from t0 + i * dt
+double maxGridError(const std::vector<double>& time)
+{
+    const double dt = (time.back() - time.front()) / (time.size() - 1);
+    double error = 0;
+    for (std::size_t i = 0; i < time.size(); ++i) {
+        error = std::max(error, std::abs(time[i] - (time.front() + i * dt)));
+    }
+    return error;
+}
+
+// Largest value difference between two tables whose rows are at the same
+// times (within `timeTolerance`, the grids are generated differently);
+// infinity, with the reason printed, if the row or column counts differ or a
+// row is at another time
+double maxTableDifference(const OpenSim::TimeSeriesTable& a,
+                          const OpenSim::TimeSeriesTable& b,
+                          double timeTolerance = 1e-9)
+{
+    if (a.getNumRows() != b.getNumRows() || a.getNumColumns() != b.getNumColumns()) {
+        std::cout << "  Shapes differ: " << a.getNumRows() << "x" << a.getNumColumns()
+                  << " vs " << b.getNumRows() << "x" << b.getNumColumns() << std::endl;
+        return SimTK::Infinity;
+    }
+    const std::vector<double>& timeA = a.getIndependentColumn();
+    const std::vector<double>& timeB = b.getIndependentColumn();
+    for (std::size_t r = 0; r < timeA.size(); ++r) {
+        if (std::abs(timeA[r] - timeB[r]) > timeTolerance) {
+            std::cout << "  Row " << r << " at time " << timeA[r] << " vs "
+                      << timeB[r] << std::endl;
+            return SimTK::Infinity;
+        }
+    }
+    double maxDifference = 0;
+    for (int r = 0; r < static_cast<int>(a.getNumRows()); ++r) {
+        for (int c = 0; c < static_cast<int>(a.getNumColumns()); ++c) {
+            maxDifference = std::max(maxDifference,
+                    std::abs(a.getMatrix()(r, c) - b.getMatrix()(r, c)));
+        }
+    }
+    return maxDifference;
+}
+
+// Compares TabOpLowPassFilterSoA against TabOpLowPassFilter on one file,
+// prints throughput of both and returns false if the results differ
+bool compareFilters(const std::string& file, double cutoffFrequency)
+{
+    const int repeats = 20;
+    const OpenSim::TimeSeriesTable table = OpenSim::TableProcessor(file).process();
+    OpenSim::TimeSeriesTable reference, soa;
+    const double referenceTime = timeFilter(
+            table, OpenSim::TabOpLowPassFilter(cutoffFrequency), repeats, reference);
+    const double soaTime = timeFilter(
+            table, OpenSim::TabOpLowPassFilterSoA(cutoffFrequency), repeats, soa);
+
+    const int nCols = static_cast<int>(soa.getNumColumns());
+    const double samples = double(soa.getNumRows()) * nCols;
+    std::cout << file << ": " << reference.getNumRows() << " vs " << soa.getNumRows()
+              << " rows, " << nCols << " columns, "
+              << (detectUniformTimeAxis(table.getIndependentColumn()) ? "uniform"
+                                                                      : "non-uniform")
+              << std::endl;
+    std::cout << "  TabOpLowPassFilter = " << referenceTime << "[µs] ("
+              << samples / referenceTime << " samples/µs), grid error = "
+              << maxGridError(reference.getIndependentColumn()) << std::endl;
+    std::cout << "  TabOpLowPassFilterSoA = " << soaTime << "[µs] ("
+              << samples / soaTime << " samples/µs), grid error = "
+              << maxGridError(soa.getIndependentColumn()) << std::endl;
+    // The reference grid is accumulated, the SoA grid is exact
+    const double maxDifference = maxTableDifference(reference, soa);
+    std::cout << "  Max difference = " << maxDifference << std::endl;
+    return maxDifference < 1e-6;
+}
+
+// Value [kB] of a /proc/self/status field such as VmHWM or VmRSS
+long statusKB(const std::string& field)
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind(field + ":", 0) == 0) {
+            return std::stol(line.substr(field.size() + 1));
+        }
+    }
+    return -1;
+}
+
+// Resets VmHWM to the current VmRSS (Linux 4.0+)
+void resetPeakMemory()
+{
+    std::ofstream("/proc/self/clear_refs") << "5";
+}
+
+// Runs `process` `repeats` times and prints its mean time and how far the
+// peak resident memory rose above the memory in use before it
+template <typename Process>
+OpenSim::TimeSeriesTable measurePipeline(const std::string& name, int repeats,
+                                         Process&& process)
+{
+    OpenSim::TimeSeriesTable result;
+    resetPeakMemory();
+    const long before = statusKB("VmRSS");
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        result = process();
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    std::cout << "  " << name << " = "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / repeats
+              << "[µs], peak memory +" << statusKB("VmHWM") - before << "[kB]" << std::endl;
+    return result;
+}
+
+// Compares the fused single-pass execution against the operator-by-operator
+// pipeline on one file; returns false if labels, times or values differ
+bool compareFused(const std::string& file, const OpenSim::Model& model)
+{
+    const int repeats = 5;
+    std::cout << file << ":" << std::endl;
+    const OpenSim::TimeSeriesTable pipeline = measurePipeline("TableProcessor", repeats, [&] {
+        return (OpenSim::TableProcessor(file) |
+                OpenSim::TabOpLowPassFilter(6) |
+                OpenSim::TabOpUseAbsoluteStateNames()).processAndConvertToRadians(model);
+    });
+    const OpenSim::TimeSeriesTable fused = measurePipeline("FusedTableProcessor", repeats, [&] {
+        return FusedTableProcessor(file).lowPassFilter(6).useAbsoluteStateNames()
+                .processAndConvertToRadians(model);
+    });
+
+    if (pipeline.getColumnLabels() != fused.getColumnLabels()) {
+        std::cout << "  Column labels differ" << std::endl;
+        return false;
+    }
+    const double maxDifference = maxTableDifference(pipeline, fused);
+    std::cout << "  Max difference = " << maxDifference << std::endl;
+    return maxDifference < 1e-6;
+}
+
 int main()
 {
     std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
@@ -55,6 +217,28 @@ int main()
    
     std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
     std::cout << "Runtime = " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << "[µs]" << std::endl;
+
+    // Non-uniform and uniform input through both filters
+    bool filtersMatch = true;
+    for (const std::string& file : {"ik_l_comf_01-000_orientations.mot",
+                                    "ik_l_comf_01-000_orientations-unif.mot"}) {
+        filtersMatch = compareFilters(file, 6) && filtersMatch;
+    }
+    if (!filtersMatch) {
+        std::cout << "TabOpLowPassFilterSoA differs from TabOpLowPassFilter" << std::endl;
+        return 1;
+    }
+
+    // Fused single pass against the operator-by-operator pipeline
+    bool fusedMatches = true;
+    for (const std::string& file : {"ik_l_comf_01-000_orientations.mot",
+                                    "ik_l_comf_01-000_orientations-unif.mot"}) {
+        fusedMatches = compareFused(file, model) && fusedMatches;
+    }
+    if (!fusedMatches) {
+        std::cout << "FusedTableProcessor differs from TableProcessor" << std::endl;
+        return 1;
+    }
     std::cout << "Finished Running without Error!" << std::endl;
     return 0;
 }
@@ -0,0 +1,399 @@
+#ifndef OPENSIM_MODEL_PREFLIGHT_H_
+#define OPENSIM_MODEL_PREFLIGHT_H_
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  ModelPreflight.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Problem found in a model file before it is handed to OpenSim. `check` is
+// one of: "read", "xml", "defaults_block", "mass", "inertia_format",
+// "inertia_negative", "inertia_triangle", "control_range", "min_control".
+struct PreflightIssue {
+  std::string file;
+  std::size_t line;
+  std::string check;
+  std::string component; // <Tag>:<name> of the offending element
+  std::string detail;
+};
+
+// Simbody's tolerance for the inertia triangle inequality (MassProperties.h):
+// Slop = max(Ixx+Iyy+Izz, 1) * NTraits<double>::getSignificant(), where
+// getSignificant() is eps^(7/8).
+inline double inertiaSlop(double Ixx, double Iyy, double Izz) {
+  static const double significant =
+      std::pow(std::numeric_limits<double>::epsilon(), 0.875);
+  return std::max(Ixx + Iyy + Izz, 1.0) * significant;
+}
+
+// The same condition Simbody enforces when constructing or shifting an
+// Inertia: Ixx+Iyy+Slop>=Izz && Ixx+Izz+Slop>=Iyy && Iyy+Izz+Slop>=Ixx
+inline bool satisfiesTriangleInequality(double Ixx, double Iyy, double Izz) {
+  const double slop = inertiaSlop(Ixx, Iyy, Izz);
+  return Ixx + Iyy + slop >= Izz && Ixx + Izz + slop >= Iyy &&
+         Iyy + Izz + slop >= Ixx;
+}
+
+// Scans the XML of an .osim file in a single pass without building a DOM or
+// loading the model. Every element keeps the text of its leaf children
+// (<mass>, <inertia>, <min_control>, ...) and is checked when it closes:
+//  - any <defaults> block (the source of the Thelen2003Muscle crashes fixed
+//    by DefaultBlockRemove)
+//  - negative or non-finite <mass>
+//  - negative or unparsable diagonals and the triangle inequality of
+//    <inertia> (4.x Vec6) or <inertia_xx>/<inertia_yy>/<inertia_zz> (3.x)
+//  - <min_control> above <max_control>
+//  - a Thelen2003Muscle <min_control> below its <minimum_activation>
+//    (default 0.01), as repaired by MinControlDefaultRepair
+class ModelPreflightScanner {
+public:
+  static std::vector<PreflightIssue> scan(const std::filesystem::path &file) {
+    std::vector<PreflightIssue> issues;
+    std::ifstream stream(file, std::ios::binary);
+    if (!stream) {
+      issues.push_back({file.string(), 0, "read", "", "could not open file"});
+      return issues;
+    }
+    const std::string xml{std::istreambuf_iterator<char>(stream),
+                          std::istreambuf_iterator<char>()};
+    ModelPreflightScanner scanner(file.string(), xml, issues);
+    scanner.run();
+    return issues;
+  }
+
+private:
+  struct Element {
+    std::string tag;
+    std::string name;
+    std::size_t line;
+    std::string text;
+    std::map<std::string, std::string, std::less<>> children;
+  };
+
+  ModelPreflightScanner(const std::string &file, std::string_view xml,
+                        std::vector<PreflightIssue> &issues)
+      : _file(file), _xml(xml), _issues(issues) {}
+
+  void run() {
+    std::size_t pos = 0;
+    while (pos < _xml.size()) {
+      const std::size_t open = _xml.find('<', pos);
+      if (!_stack.empty()) {
+        _stack.back().text.append(
+            _xml.substr(pos, std::min(open, _xml.size()) - pos));
+      }
+      if (open == std::string_view::npos) {
+        break;
+      }
+      if (_xml.compare(open, 4, "<!--") == 0) {
+        pos = skipPast(open, "-->");
+      } else if (_xml.compare(open, 2, "<?") == 0) {
+        pos = skipPast(open, "?>");
+      } else if (_xml.compare(open, 9, "<![CDATA[") == 0) {
+        const std::size_t end = _xml.find("]]>", open);
+        if (!_stack.empty() && end != std::string_view::npos) {
+          _stack.back().text.append(_xml.substr(open + 9, end - open - 9));
+        }
+        pos = skipPast(open, "]]>");
+      } else if (_xml.compare(open, 2, "<!") == 0) {
+        pos = skipPast(open, ">");
+      } else {
+        pos = readTag(open);
+      }
+    }
+    if (!_stack.empty()) {
+      report(_stack.back(), "xml", "element is never closed");
+    }
+  }
+
+  // Position after `terminator`, or the end of the input if it is missing
+  std::size_t skipPast(std::size_t from, std::string_view terminator) {
+    const std::size_t end = _xml.find(terminator, from);
+    if (end == std::string_view::npos) {
+      _issues.push_back({_file, lineOf(from), "xml", "",
+                         "unterminated markup, expected " +
+                             std::string(terminator)});
+      return _xml.size();
+    }
+    return end + terminator.size();
+  }
+
+  std::size_t readTag(std::size_t open) {
+    const std::size_t close = _xml.find('>', open);
+    if (close == std::string_view::npos) {
+      _issues.push_back({_file, lineOf(open), "xml", "", "unterminated tag"});
+      return _xml.size();
+    }
+    std::string_view tag = _xml.substr(open + 1, close - open - 1);
+    if (!tag.empty() && tag.front() == '/') {
+      closeElement(trim(tag.substr(1)), open);
+      return close + 1;
+    }
+    const bool selfClosing = !tag.empty() && tag.back() == '/';
+    if (selfClosing) {
+      tag.remove_suffix(1);
+    }
+    const std::size_t nameEnd = tag.find_first_of(" \t\r\n");
+    Element element;
+    element.tag = std::string(tag.substr(0, nameEnd));
+    element.name = attribute(tag, "name");
+    element.line = lineOf(open);
+    _stack.push_back(std::move(element));
+    if (selfClosing) {
+      closeElement(_stack.back().tag, open);
+    }
+    return close + 1;
+  }
+
+  static std::string attribute(std::string_view tag, std::string_view key) {
+    std::size_t pos = 0;
+    while ((pos = tag.find(key, pos)) != std::string_view::npos) {
+      const bool startsWord =
+          pos > 0 && std::isspace(static_cast<unsigned char>(tag[pos - 1]));
+      std::size_t eq = pos + key.size();
+      while (eq < tag.size() &&
+             std::isspace(static_cast<unsigned char>(tag[eq]))) {
+        ++eq;
+      }
+      if (startsWord && eq < tag.size() && tag[eq] == '=') {
+        const std::size_t quote = tag.find_first_of("\"'", eq);
+        if (quote == std::string_view::npos) {
+          return "";
+        }
+        const std::size_t end = tag.find(tag[quote], quote + 1);
+        return std::string(tag.substr(quote + 1, end - quote - 1));
+      }
+      pos += key.size();
+    }
+    return "";
+  }
+
+  void closeElement(std::string_view tag, std::size_t at) {
+    if (_stack.empty() || _stack.back().tag != tag) {
+      _issues.push_back({_file, lineOf(at), "xml", std::string(tag),
+                         "closing tag does not match the open element"});
+      return;
+    }
+    Element element = std::move(_stack.back());
+    _stack.pop_back();
+    check(element);
+    // Leaf values become properties of the enclosing element
+    if (!_stack.empty() && element.children.empty()) {
+      _stack.back().children.emplace(element.tag,
+                                     std::string(trim(element.text)));
+    }
+  }
+
+  void check(const Element &e) {
+    if (e.tag == "defaults") {
+      report(e, "defaults_block",
+             "<defaults> is not supported by OpenSim 4 and must be removed");
+    }
+
+    double mass = 0;
+    if (property(e, "mass", mass) && !(mass >= 0 && std::isfinite(mass))) {
+      report(e, "mass", "mass=" + format(mass));
+    }
+
+    std::vector<double> inertia;
+    if (const auto it = e.children.find("inertia"); it != e.children.end()) {
+      inertia = numbers(it->second);
+      if (inertia.size() < 3) {
+        report(e, "inertia_format",
+               "expected [Ixx Iyy Izz Ixy Ixz Iyz], got '" + it->second + "'");
+        inertia.clear();
+      }
+    } else {
+      double Ixx = 0, Iyy = 0, Izz = 0;
+      if (property(e, "inertia_xx", Ixx) && property(e, "inertia_yy", Iyy) &&
+          property(e, "inertia_zz", Izz)) {
+        inertia = {Ixx, Iyy, Izz};
+      }
+    }
+    if (!inertia.empty()) {
+      const double Ixx = inertia[0], Iyy = inertia[1], Izz = inertia[2];
+      const std::string diagonals = "Ixx=" + format(Ixx) + ",Iyy=" +
+                                    format(Iyy) + ",Izz=" + format(Izz);
+      if (!(Ixx >= 0 && Iyy >= 0 && Izz >= 0) || !std::isfinite(Ixx) ||
+          !std::isfinite(Iyy) || !std::isfinite(Izz)) {
+        report(e, "inertia_negative", diagonals);
+      } else if (!satisfiesTriangleInequality(Ixx, Iyy, Izz)) {
+        report(e, "inertia_triangle",
+               diagonals + ",slop=" + format(inertiaSlop(Ixx, Iyy, Izz)));
+      }
+    }
+
+    double minControl = 0, maxControl = 0;
+    const bool hasMin = property(e, "min_control", minControl);
+    const bool hasMax = property(e, "max_control", maxControl);
+    if (hasMin && hasMax && !(minControl <= maxControl)) {
+      report(e, "control_range",
+             "min_control=" + format(minControl) +
+                 ",max_control=" + format(maxControl));
+    }
+    if (hasMin && e.tag == "Thelen2003Muscle") {
+      double minActivation = 0.01;
+      property(e, "minimum_activation", minActivation);
+      if (!(minControl >= minActivation)) {
+        report(e, "min_control",
+               "min_control=" + format(minControl) +
+                   " below minimum_activation=" + format(minActivation));
+      }
+    }
+  }
+
+  // Parses a single number child; a present but unparsable value parses to
+  // NaN so that the range checks above reject it
+  static bool property(const Element &e, std::string_view key, double &value) {
+    const auto it = e.children.find(key);
+    if (it == e.children.end()) {
+      return false;
+    }
+    const std::vector<double> values = numbers(it->second);
+    value = values.size() == 1 ? values[0]
+                               : std::numeric_limits<double>::quiet_NaN();
+    return true;
+  }
+
+  static std::vector<double> numbers(std::string_view text) {
+    std::vector<double> values;
+    std::size_t pos = 0;
+    while ((pos = text.find_first_not_of(" \t\r\n", pos)) !=
+           std::string_view::npos) {
+      const std::size_t end = std::min(text.find_first_of(" \t\r\n", pos),
+                                       text.size());
+      double value = std::numeric_limits<double>::quiet_NaN();
+      const auto [ptr, ec] =
+          std::from_chars(text.data() + pos, text.data() + end, value);
+      if (ec != std::errc() || ptr != text.data() + end) {
+        value = std::numeric_limits<double>::quiet_NaN();
+      }
+      values.push_back(value);
+      pos = end;
+    }
+    return values;
+  }
+
+  static std::string_view trim(std::string_view s) {
+    const std::size_t first = s.find_first_not_of(" \t\r\n");
+    if (first == std::string_view::npos) {
+      return {};
+    }
+    return s.substr(first, s.find_last_not_of(" \t\r\n") - first + 1);
+  }
+
+  static std::string format(double value) {
+    std::ostringstream ss;
+    ss.precision(std::numeric_limits<double>::max_digits10);
+    ss << value;
+    return ss.str();
+  }
+
+  void report(const Element &e, const std::string &check,
+              const std::string &detail) {
+    _issues.push_back({_file, e.line, check, e.tag + ":" + e.name, detail});
+  }
+
+  // Lines are counted incrementally since tags are visited in order
+  std::size_t lineOf(std::size_t pos) {
+    if (pos > _linePos) {
+      _line += std::count(_xml.begin() + _linePos, _xml.begin() + pos, '\n');
+      _linePos = pos;
+    }
+    return _line;
+  }
+
+  const std::string _file;
+  std::string_view _xml;
+  std::vector<PreflightIssue> &_issues;
+  std::vector<Element> _stack;
+  std::size_t _line = 1;
+  std::size_t _linePos = 0;
+};
+
+inline std::vector<PreflightIssue>
+preflightModel(const std::filesystem::path &file) {
+  return ModelPreflightScanner::scan(file);
+}
+
+// Machine-readable report: one CSV row per issue
+inline void writePreflightReport(std::ostream &out,
+                                 const std::vector<PreflightIssue> &issues) {
+  auto field = [](const std::string &value) {
+    if (value.find_first_of(",\"\n") == std::string::npos) {
+      return value;
+    }
+    std::string quoted = "\"";
+    for (const char c : value) {
+      quoted += c;
+      if (c == '"') {
+        quoted += '"';
+      }
+    }
+    return quoted + "\"";
+  };
+  out << "file,line,check,component,detail\n";
+  for (const PreflightIssue &issue : issues) {
+    out << field(issue.file) << ',' << issue.line << ',' << issue.check << ','
+        << field(issue.component) << ',' << field(issue.detail) << '\n';
+  }
+}
+
+// Scans each model once for tools that look the same model up per trial
+class ModelPreflightCache {
+public:
+  const std::vector<PreflightIssue> &check(const std::string &fileName) {
+    auto it = _results.find(fileName);
+    if (it == _results.end()) {
+      it = _results.emplace(fileName, preflightModel(fileName)).first;
+    }
+    return it->second;
+  }
+
+  // Every issue found so far, in file name order
+  std::vector<PreflightIssue> issues() const {
+    std::vector<PreflightIssue> all;
+    for (const auto &[file, issues] : _results) {
+      all.insert(all.end(), issues.begin(), issues.end());
+    }
+    return all;
+  }
+
+private:
+  std::map<std::string, std::vector<PreflightIssue>> _results;
+};
+
+#endif // OPENSIM_MODEL_PREFLIGHT_H_
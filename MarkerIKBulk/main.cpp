@@ -6,6 +6,10 @@
 
 // Thread Pool
 #include "BS_thread_pool.hpp" // BS::synced_stream, BS::thread_pool
+#include "IKSeedCache.h"
+#include "ModelPreflight.h"
+
+#include "ParticipantStore.h"
 
 #include <algorithm> // For std::find_if
 #include <chrono>    // for std::chrono functions
@@ -14,6 +18,7 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -31,15 +36,11 @@ typedef std::pair<std::string, std::string> ConfigType;
 // const std::vector<std::string> includedParticipants = {
 //     "08", "09", "12", "17", "19", "21", "24",
 //     "28", "31", "34", "36", "38", "40", "41"};
-// All trials - excluded no IMUs collected - some subjects (11, 14, 37, 49) do not have keypoint and IMU data.
-const std::vector<std::string> includedParticipants = {
-    "01", "02", "03", "04", "05", "06", "07", "08", "09", 
-    "10", "12", "13", "15", "16", "17", "18", 
-    "19", "20", "21", "22", "23", "24", "25", "26", "27", 
-    "28", "29", "30", "31", "32", "33", "34", "35", "36", 
-    "38", "39", "40", "41", "42", "43", "44", "45", 
-    "46", "47", "48", "50", "51"
-};
+// All trials - invalid trials are dropped by the ParticipantStore
+const std::vector<std::string> includedParticipants = {};
+const std::string preflightReportFile = "model_preflight.csv";
+const std::string ikSeedCacheFile = "ik_seed_cache.tsv";
+const std::string fileNameParticipants = "info_participants.csv";
 
 const std::vector<ConfigType> config = {
     // {"kuopio_base_IK_Tasks_uniform.xml",
@@ -62,22 +63,19 @@ const SimTK::Vec3 rotations(-SimTK::Pi / 2, SimTK::Pi / 2, 0);
 // Function to rotate a table of Vec3 elements
 void rotateMarkerTable(OpenSim::TimeSeriesTableVec3 &table,
                        const SimTK::Rotation_<double> &rotationMatrix) {
+  // In place, column by column: the table's Vec3 matrix is column-major
   const SimTK::Rotation R_XG = rotationMatrix;
-
-  int nc = int(table.getNumColumns());
-  size_t nt = table.getNumRows();
-
-  for (size_t i = 0; i < nt; ++i) {
-    auto row = table.updRowAtIndex(i);
-    for (int j = 0; j < nc; ++j) {
-      row[j] = R_XG * row[j];
+  SimTK::Matrix_<SimTK::Vec3> &matrix = table.updMatrix();
+  for (int j = 0; j < matrix.ncol(); ++j) {
+    for (int i = 0; i < matrix.nrow(); ++i) {
+      matrix(i, j) = R_XG * matrix(i, j);
     }
   }
-  return;
 }
 
 void process(const std::filesystem::path &file,
-             const std::filesystem::path &resultDir, const ConfigType &c) {
+             const std::filesystem::path &resultDir, const ConfigType &c,
+             IKSeedCache &seeds) {
   sync_out.println("---Starting Marker IK Processing: ", file.string());
   try {
     OpenSim::IO::SetDigitsPad(4);
@@ -137,6 +135,25 @@ void process(const std::filesystem::path &file,
       ik.set_report_marker_locations(false);
       ik.set_model_file(modelSourcePath.string());
 
+      // Start the first frame from the pose an earlier run converged to
+      const std::string participant =
+          file.parent_path().parent_path().filename().string();
+      const std::string trial =
+          ParticipantStore::trialOf(file.stem().string());
+      // Keyed on model and task set, as other weights converge elsewhere
+      const std::string seedKey =
+          modelSourceStem + sep +
+          std::filesystem::path(fileNameIKTaskSet).stem().string();
+      OpenSim::Model model(modelSourcePath.string());
+      const std::optional<IKSeed> seed =
+          seeds.find(participant, trial, seedKey);
+      if (seed) {
+        IKSeedCache::applySeed(model, *seed);
+      }
+      sync_out.println("First frame starts from ",
+                       seed ? "cached seed" : "default pose");
+      ik.setModel(model);
+
       ik.set_marker_file((resultDir / markerFileName).string());
       // ik.setMarkerDataFileName(markerFileName);
       ik.set_output_motion_file(outputMotionFile.string());
@@ -157,6 +174,11 @@ void process(const std::filesystem::path &file,
         startTime += timeIncrement;
         ik.setStartTime(startTime);
       } while (!ikSuccess && startTime < endTime);
+      if (ikSuccess && !seed) {
+        seeds.store(participant, trial, seedKey,
+                    IKSeedCache::firstFramePose(outputMotionFile.string(),
+                                                model));
+      }
       ik.print((resultDir / (outputFilePrefix + sep + "marker_ik_output.xml"))
                    .string());
     }
@@ -188,10 +210,14 @@ void collectFiles(const std::filesystem::path &directory,
   }
 }
 
-// Function to filter files based on specific criteria
-void filterFiles(const std::vector<std::filesystem::path> &allFiles,
-                 std::vector<std::filesystem::path> &filteredFiles,
-                 const std::vector<std::string> &includedParticipants) {
+// Function to filter files based on specific criteria. An empty
+// includedParticipants selects everyone; files the participant store rules
+// out (unknown participant, invalid trial) are dropped and counted.
+std::size_t filterFiles(const std::vector<std::filesystem::path> &allFiles,
+                        std::vector<std::filesystem::path> &filteredFiles,
+                        const ParticipantStore &participants,
+                        const std::vector<std::string> &includedParticipants) {
+  std::size_t skipped = 0;
   for (const auto &path : allFiles) {
     std::string filename = path.stem().string();
 
@@ -204,16 +230,22 @@ void filterFiles(const std::vector<std::filesystem::path> &allFiles,
     // Check if the participant ID is in the included list
     const auto it = std::find(includedParticipants.begin(),
                               includedParticipants.end(), participantId);
-    const bool participantIncluded = it != includedParticipants.end();
+    const bool participantIncluded =
+        includedParticipants.empty() || it != includedParticipants.end();
 
     // Check the file extension and naming conditions
     if (path.extension() == ".trc" &&
         (filename.rfind("l_", 0) == 0 || filename.rfind("r_", 0) == 0) &&
         participantIncluded) {
+      if (!participants.isRunnable(participantId, filename)) {
+        ++skipped;
+        continue;
+      }
       // Add the file to the filtered vector if all conditions are met
       filteredFiles.push_back(path);
     }
   }
+  return skipped;
 }
 
 // Function to create the required directory structure
@@ -282,8 +314,12 @@ int main(int argc, char *argv[]) {
   collectFiles(directoryPath, allFiles);
 
   // Filter the collected files based on the criteria
+  const ParticipantStore participants(fileNameParticipants);
   std::vector<std::filesystem::path> filteredFiles;
-  filterFiles(allFiles, filteredFiles, includedParticipants);
+  const std::size_t skipped =
+      filterFiles(allFiles, filteredFiles, participants, includedParticipants);
+  sync_out.println("Trials: ", filteredFiles.size(),
+                   " skipped (invalid): ", skipped);
 
   // Create directories for each filtered file
   for (const auto &file : filteredFiles) {
@@ -292,6 +328,11 @@ int main(int argc, char *argv[]) {
 
   // Create configuration for running IK
   OpenSim::IO::SetDigitsPad(4);
+  // Models that would throw inside Simbody are rejected before scheduling
+  ModelPreflightCache preflight;
+  std::size_t rejectedTasks = 0;
+  IKSeedCache seedCache((outputPath / ikSeedCacheFile).string());
+  sync_out.println("IK seeds cached: ", seedCache.size());
   for (const auto &file : filteredFiles) {
     for (const auto &c : config) {
       const std::filesystem::path firstParent = file.parent_path();
@@ -311,6 +352,12 @@ int main(int argc, char *argv[]) {
       const std::filesystem::path setupIKSourcePath(fileNameSetupIK);
       const std::filesystem::path setupIKDestinationPath =
           resultDir / fileNameSetupIK;
+      if (!preflight.check(modelSourcePath.string()).empty()) {
+        sync_out.println("Model rejected by preflight: ", modelSourcePath,
+                         " File: ", file.stem().string());
+        ++rejectedTasks;
+        continue;
+      }
       try {
         // Copy the file to the destination directory
         std::filesystem::copy_file(
@@ -321,8 +368,8 @@ int main(int argc, char *argv[]) {
             std::filesystem::copy_options::update_existing);
 
         const ConfigType newConfig = {c.first, (modelSourcePath).string()};
-        pool.detach_task([file, resultDir, newConfig] {
-          process(file, resultDir, newConfig);
+        pool.detach_task([file, resultDir, newConfig, &seedCache] {
+          process(file, resultDir, newConfig, seedCache);
         });
       } catch (const std::filesystem::filesystem_error &e) {
         sync_out.println("Error in copying File: ", e.what());
@@ -331,6 +378,16 @@ int main(int argc, char *argv[]) {
   }
   // Wait for all tasks to finish
   pool.wait();
+  seedCache.save();
+
+  const std::vector<PreflightIssue> preflightIssues = preflight.issues();
+  if (!preflightIssues.empty()) {
+    const std::filesystem::path reportFile = outputPath / preflightReportFile;
+    std::ofstream report(reportFile);
+    writePreflightReport(report, preflightIssues);
+    sync_out.println("Tasks rejected by preflight: ", rejectedTasks,
+                     " Report: ", reportFile);
+  }
 
   std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
   const double runtime =
@@ -0,0 +1,168 @@
+#ifndef OPENSIM_IK_SEED_CACHE_H_
+#define OPENSIM_IK_SEED_CACHE_H_
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  IKSeedCache.h                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Common/Exception.h>
+#include <OpenSim/Common/TimeSeriesTable.h>
+#include <OpenSim/Simulation/Model/Model.h>
+
+#include <charconv>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+
+// Coordinate values (radians/meters) by coordinate name
+typedef std::map<std::string, double> IKSeed;
+
+// Converged first-frame poses of earlier IK runs, keyed by (participant,
+// trial, model). IK starts its first frame from the model's default pose; a
+// run that finds a seed sets it as the coordinates' default values instead,
+// so the first assembly starts next to the solution.
+//
+// File format (tab separated, one run per line):
+//   <participant> <trial> <model> <coordinate>=<value> ...
+// Values are written with max_digits10 so they round-trip exactly.
+class IKSeedCache {
+public:
+  explicit IKSeedCache(const std::string &fileName) : _fileName(fileName) {
+    std::ifstream file(fileName);
+    std::string line;
+    while (std::getline(file, line)) {
+      std::istringstream ss(line);
+      std::string participant, trial, model, field;
+      if (!std::getline(ss, participant, '\t') ||
+          !std::getline(ss, trial, '\t') || !std::getline(ss, model, '\t')) {
+        continue;
+      }
+      IKSeed seed;
+      while (std::getline(ss, field, '\t')) {
+        const std::size_t eq = field.find('=');
+        double value = 0;
+        if (eq == std::string::npos) {
+          continue;
+        }
+        // from_chars, unlike stod, does not depend on the C locale
+        const auto [ptr, ec] = std::from_chars(
+            field.data() + eq + 1, field.data() + field.size(), value);
+        if (ec == std::errc()) {
+          seed[field.substr(0, eq)] = value;
+        }
+      }
+      _seeds[key(participant, trial, model)] = std::move(seed);
+    }
+  }
+
+  std::optional<IKSeed> find(const std::string &participant,
+                             const std::string &trial,
+                             const std::string &model) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _seeds.find(key(participant, trial, model));
+    if (it == _seeds.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  void store(const std::string &participant, const std::string &trial,
+             const std::string &model, IKSeed seed) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _seeds[key(participant, trial, model)] = std::move(seed);
+  }
+
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _seeds.size();
+  }
+
+  void save() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::ofstream file(_fileName);
+    OPENSIM_THROW_IF(!file, OpenSim::Exception, "Could not write " + _fileName);
+    file.precision(std::numeric_limits<double>::max_digits10);
+    for (const auto &[k, seed] : _seeds) {
+      file << k;
+      for (const auto &[coordinate, value] : seed) {
+        file << '\t' << coordinate << '=' << value;
+      }
+      file << '\n';
+    }
+  }
+
+  // The first row of an IK output motion as a seed for `model`; rotational
+  // coordinates are converted to radians if the motion is in degrees
+  static IKSeed firstFramePose(const std::string &motionFile,
+                               const OpenSim::Model &model) {
+    const OpenSim::TimeSeriesTable table(motionFile);
+    OPENSIM_THROW_IF(table.getNumRows() == 0, OpenSim::Exception,
+                     "No frames in " + motionFile);
+    const auto &meta = table.getTableMetaData();
+    const bool inDegrees =
+        meta.hasKey("inDegrees") &&
+        meta.getValueForKey("inDegrees").getValue<std::string>() == "yes";
+
+    IKSeed seed;
+    const auto row = table.getRowAtIndex(0);
+    const auto &labels = table.getColumnLabels();
+    const OpenSim::CoordinateSet &coordinates = model.getCoordinateSet();
+    for (std::size_t i = 0; i < labels.size(); ++i) {
+      if (!coordinates.contains(labels[i])) {
+        continue;
+      }
+      double value = row[static_cast<int>(i)];
+      if (inDegrees && coordinates.get(labels[i]).getMotionType() ==
+                           OpenSim::Coordinate::Rotational) {
+        value *= SimTK_DEGREE_TO_RADIAN;
+      }
+      seed[labels[i]] = value;
+    }
+    return seed;
+  }
+
+  // Makes the seed the model's default pose; call before initSystem()
+  static void applySeed(OpenSim::Model &model, const IKSeed &seed) {
+    OpenSim::CoordinateSet &coordinates = model.updCoordinateSet();
+    for (const auto &[name, value] : seed) {
+      if (coordinates.contains(name)) {
+        coordinates.get(name).setDefaultValue(value);
+      }
+    }
+  }
+
+private:
+  static std::string key(const std::string &participant,
+                         const std::string &trial, const std::string &model) {
+    return participant + '\t' + trial + '\t' + model;
+  }
+
+  std::string _fileName;
+  std::map<std::string, IKSeed> _seeds;
+  mutable std::mutex _mutex;
+};
+
+#endif // OPENSIM_IK_SEED_CACHE_H_
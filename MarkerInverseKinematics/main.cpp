@@ -23,14 +23,54 @@
 
 
 // INCLUDES
+#include <OpenSim/Simulation/InverseKinematicsSolver.h>
+#include <OpenSim/Simulation/MarkersReference.h>
 #include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/OrientationsReference.h>
 #include <OpenSim/Tools/InverseKinematicsTool.h>
 
+#include "IKSeedCache.h"
+
+#include <memory>
+#include <optional>
 #include <string>
 #include <iostream>
 #include <clocale>
 #include <chrono> // for std::chrono functions
 
+// The IK tools do not report iterations; AssemblySolver keeps its
+// SimTK::Assembler protected, so expose its step count here
+class CountingInverseKinematicsSolver : public OpenSim::InverseKinematicsSolver
+{
+public:
+    using OpenSim::InverseKinematicsSolver::InverseKinematicsSolver;
+    int getNumAssemblySteps() const { return _assembler->getNumAssemblySteps(); }
+};
+
+// Assembler steps to solve the first frame of the trial, starting from the
+// model's default pose or from `seed`. The marker and coordinate references
+// (with the IKTaskSet weights) come from the tool itself, so this is the
+// problem its first frame solves.
+int firstFrameSteps(const std::string& modelFile,
+                    const OpenSim::InverseKinematicsTool& ik, const IKSeed* seed)
+{
+    OpenSim::Model model(modelFile);
+    if (seed) {
+        IKSeedCache::applySeed(model, *seed);
+    }
+    SimTK::State& s = model.initSystem();
+    auto markersRef = std::make_shared<OpenSim::MarkersReference>();
+    SimTK::Array_<OpenSim::CoordinateReference> coordinateRefs;
+    ik.populateReferences(model, *markersRef, coordinateRefs);
+    CountingInverseKinematicsSolver solver(model, markersRef,
+            std::make_shared<OpenSim::OrientationsReference>(), coordinateRefs,
+            ik.get_constraint_weight());
+    solver.setAccuracy(ik.get_accuracy());
+    s.updTime() = ik.getStartTime();
+    solver.assemble(s);
+    return solver.getNumAssemblySteps();
+}
+
 int main()
 {
     std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
@@ -42,6 +82,21 @@ int main()
     ik.setModel(mdl);
     ik.run();
 
+    // Store the converged first frame in a seed cache, reload it and compare
+    // the first-frame work with and without the seed
+    IKSeedCache seeds("ik_seed_cache.tsv");
+    seeds.store("subject01", "l_comf_01", mdl.getName(),
+                IKSeedCache::firstFramePose(ik.get_output_motion_file(), mdl));
+    seeds.save();
+    const std::optional<IKSeed> seed =
+            IKSeedCache("ik_seed_cache.tsv").find("subject01", "l_comf_01", mdl.getName());
+    const int defaultSteps = firstFrameSteps("subject01_simbody_adjusted.osim",
+                                             ik, nullptr);
+    const int seededSteps = firstFrameSteps("subject01_simbody_adjusted.osim",
+                                            ik, &seed.value());
+    std::cout << "First frame assembler steps: default pose = " << defaultSteps
+              << ", cached seed = " << seededSteps << std::endl;
+
     std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
     std::cout << "Runtime = " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << "[µs]" << std::endl;
     std::cout << "Finished Running without Error!" << std::endl;
@@ -0,0 +1,145 @@
+#ifndef OPENSIM_MARKER_DISTANCE_KERNEL_H_
+#define OPENSIM_MARKER_DISTANCE_KERNEL_H_
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  MarkerDistanceKernel.h                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Common/MarkerData.h>
+
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Marker trajectories of a static trial in structure-of-arrays form (one
+// contiguous x, y and z array per marker) and the distance of every
+// registered marker pair for all frames. compute() fills the distances of
+// the pairs added since the last call in one SIMD pass over the frames.
+//
+// meanDistance() reproduces ModelScaler::takeExperimentalMarkerMeasurement()
+// bit for bit: lengths are sqrt(dx*dx + dy*dy + dz*dz) as in Vec3::norm()
+// and are summed in frame order. Build with -ffp-contract=off so the squares
+// are not fused into FMAs, and -fno-math-errno so std::sqrt vectorizes.
+class MarkerDistanceKernel {
+public:
+    explicit MarkerDistanceKernel(const OpenSim::MarkerData& markerData)
+        : _numFrames(markerData.getNumFrames()) {
+        const OpenSim::Array<std::string>& names = markerData.getMarkerNames();
+        const int numMarkers = markerData.getNumMarkers();
+        _x.resize(std::size_t(numMarkers) * _numFrames);
+        _y.resize(_x.size());
+        _z.resize(_x.size());
+        for (int m = 0; m < numMarkers; ++m) {
+            _markerIndex.emplace(names[m], m);
+        }
+        for (int f = 0; f < _numFrames; ++f) {
+            const OpenSim::MarkerFrame& frame = markerData.getFrame(f);
+            for (int m = 0; m < numMarkers; ++m) {
+                const SimTK::Vec3& p = frame.getMarker(m);
+                const std::size_t k = std::size_t(m) * _numFrames + f;
+                _x[k] = p[0];
+                _y[k] = p[1];
+                _z[k] = p[2];
+            }
+        }
+    }
+
+    int getNumFrames() const { return _numFrames; }
+
+    // Index of the pair's distances; the pair is added on first use.
+    // Returns -1 if either marker is not in the trial.
+    int addPair(const std::string& name1, const std::string& name2) {
+        const auto key = std::make_pair(name1, name2);
+        const auto it = _pairIndex.find(key);
+        if (it != _pairIndex.end()) {
+            return it->second;
+        }
+        const auto m1 = _markerIndex.find(name1);
+        const auto m2 = _markerIndex.find(name2);
+        if (m1 == _markerIndex.end() || m2 == _markerIndex.end()) {
+            return -1;
+        }
+        const int pair = static_cast<int>(_pairs.size());
+        _pairs.emplace_back(m1->second, m2->second);
+        _pairIndex.emplace(key, pair);
+        return pair;
+    }
+
+    // Distances and presence masks of the pairs added since the last call
+    void compute() {
+        const std::size_t n = _numFrames;
+        _length.resize(_pairs.size() * n);
+        _present.resize(_pairs.size() * n);
+        for (std::size_t p = _numComputed; p < _pairs.size(); ++p) {
+            const double* x1 = &_x[std::size_t(_pairs[p].first) * n];
+            const double* y1 = &_y[std::size_t(_pairs[p].first) * n];
+            const double* z1 = &_z[std::size_t(_pairs[p].first) * n];
+            const double* x2 = &_x[std::size_t(_pairs[p].second) * n];
+            const double* y2 = &_y[std::size_t(_pairs[p].second) * n];
+            const double* z2 = &_z[std::size_t(_pairs[p].second) * n];
+            double* length = &_length[p * n];
+            std::uint8_t* present = &_present[p * n];
+#pragma omp simd
+            for (std::size_t f = 0; f < n; ++f) {
+                const double dx = x1[f] - x2[f];
+                const double dy = y1[f] - y2[f];
+                const double dz = z1[f] - z2[f];
+                const double l = std::sqrt(dx * dx + dy * dy + dz * dz);
+                length[f] = l;
+                // NaN coordinates (missing markers) give a NaN length
+                present[f] = l == l;
+            }
+        }
+        _numComputed = _pairs.size();
+    }
+
+    // Mean distance of a computed pair over frames [startFrame, endFrame],
+    // leaving out frames where either marker is missing. NaN if none is
+    // present.
+    double meanDistance(int pair, int startFrame, int endFrame) const {
+        const std::size_t offset = std::size_t(pair) * _numFrames;
+        double distance = 0;
+        int count = 0;
+        for (int f = startFrame; f <= endFrame; ++f) {
+            if (_present[offset + f]) {
+                distance += _length[offset + f];
+                ++count;
+            }
+        }
+        return count > 0 ? distance / count : SimTK::NaN;
+    }
+
+private:
+    int _numFrames;
+    std::vector<double> _x, _y, _z;
+    std::map<std::string, int> _markerIndex;
+    std::vector<std::pair<int, int>> _pairs;
+    std::map<std::pair<std::string, std::string>, int> _pairIndex;
+    std::size_t _numComputed = 0;
+    std::vector<double> _length;
+    std::vector<std::uint8_t> _present;
+};
+
+#endif // OPENSIM_MARKER_DISTANCE_KERNEL_H_
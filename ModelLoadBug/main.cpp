@@ -27,13 +27,111 @@
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Tools/GenericModelMaker.h>
 
+#include "ScaleTemplate.h"
+
 #include <memory>
 #include <string>
 #include <filesystem>
 #include <iostream>
 #include <clocale>
 #include <chrono> // for std::chrono functions
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Regression check for the shared template mode of ScaleToolBulk: the generic
+// model and marker set are loaded once and many participants scale their own
+// clone concurrently. Every clone must come with the full marker set attached
+// to the right frames, and scaling a clone must leave the template untouched.
+bool checkSharedTemplate(const std::string& fileNameModel,
+        const std::string& fileNameMarkerSet, int participants, int workers)
+{
+    const ScaleTemplate scaleTemplate(fileNameModel, fileNameMarkerSet);
+    const OpenSim::MarkerSet& templateMarkers = scaleTemplate.getModel().getMarkerSet();
+    std::vector<std::string> frames;
+    std::vector<SimTK::Vec3> locations;
+    for (int m = 0; m < templateMarkers.getSize(); ++m) {
+        frames.push_back(templateMarkers[m].getParentFrame().getAbsolutePathString());
+        locations.push_back(templateMarkers[m].get_location());
+    }
+    if (templateMarkers.getSize() == 0) {
+        std::cerr << "Template has no markers" << std::endl;
+        return false;
+    }
+
+    std::atomic<int> failures{0};
+    auto participant = [&](int i) {
+        try {
+            std::unique_ptr<OpenSim::Model> model = scaleTemplate.cloneModel();
+            const OpenSim::MarkerSet& markers = model->getMarkerSet();
+            bool valid = markers.getSize() == templateMarkers.getSize();
+            for (int m = 0; valid && m < markers.getSize(); ++m) {
+                valid = markers[m].getName() == templateMarkers[m].getName() &&
+                    markers[m].getParentFrame().getAbsolutePathString() == frames[m];
+            }
+            // Scale the clone like a participant would be scaled
+            OpenSim::ScaleSet scaleSet;
+            for (int b = 0; b < model->getBodySet().getSize(); ++b) {
+                OpenSim::Scale scale;
+                scale.setSegmentName(model->getBodySet()[b].getName());
+                scale.setScaleFactors(SimTK::Vec3(0.9 + 0.005 * (i % 40)));
+                scale.setApply(true);
+                scaleSet.cloneAndAppend(scale);
+            }
+            SimTK::State& s = model->updWorkingState();
+            valid = valid && model->scale(s, scaleSet, true, 60.0 + i % 30);
+            if (!valid) {
+                std::cerr << "[" << i << "] Invalid clone of the template" << std::endl;
+                ++failures;
+            }
+        } catch (const std::exception& x) {
+            std::cerr << "[" << i << "] " << x.what() << std::endl;
+            ++failures;
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int w = 0; w < workers; ++w) {
+        threads.emplace_back([&, w] {
+            for (int i = w; i < participants; i += workers) {
+                participant(i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
 
+    // The template itself must not have been modified by any participant
+    for (int m = 0; m < templateMarkers.getSize(); ++m) {
+        if (templateMarkers[m].get_location() != locations[m]) {
+            std::cerr << "Template marker changed: " << templateMarkers[m].getName() << std::endl;
+            ++failures;
+        }
+    }
+    std::cout << "Shared template: " << participants << " participants, "
+              << failures << " failures" << std::endl;
+    return failures == 0;
+}
+
+// Measurements without marker pairs must come out NaN and be skipped, as in
+// ModelScaler::computeMeasurementScaleFactor(), not scale their bodies by 0.
+bool checkMeasurementScaleFactor()
+{
+    const auto ratio = [](const std::string&, const std::string&) { return 2.0; };
+    OpenSim::Measurement noPairs;
+    noPairs.setName("no_pairs");
+    const double noPairsFactor = ScaleTemplate::measurementScaleFactor(noPairs, ratio);
+
+    OpenSim::Measurement onePair;
+    onePair.setName("one_pair");
+    onePair.getMarkerPairSet().cloneAndAppend(OpenSim::MarkerPair("A", "B"));
+    const double onePairFactor = ScaleTemplate::measurementScaleFactor(onePair, ratio);
+
+    const bool valid = SimTK::isNaN(noPairsFactor) && onePairFactor == 2.0;
+    std::cout << "Measurement scale factors: no pairs = " << noPairsFactor
+              << ", one pair = " << onePairFactor << std::endl;
+    return valid;
+}
 
 int main()
 {
@@ -84,8 +182,19 @@ int main()
     }
 
    
+    std::cout << "\n\nTesting shared ScaleTemplate!" << std::endl;
+    const std::string fileNameMarkerSetBulk = "kg_gait2392_thelen2003muscle_Scale_MarkerSet.xml";
+    const bool templateValid =
+        checkSharedTemplate(fileNameModel, fileNameMarkerSetBulk, 52, 4) &&
+        checkSharedTemplate(fileNameModel, fileNameMarkerSetWorking, 52, 4) &&
+        checkMeasurementScaleFactor();
+
     std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
     std::cout << "Runtime = " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << "[µs]" << std::endl;
+    if (!templateValid) {
+        std::cerr << "Shared ScaleTemplate regression FAILED" << std::endl;
+        return 1;
+    }
     std::cout << "Finished Running without Error!" << std::endl;
-    // return 0;
+    return 0;
 }
@@ -0,0 +1,131 @@
+/* -------------------------------------------------------------------------- *
+ *                            OpenSim:  main.cpp                              *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+// Thread Pool
+#include "BS_thread_pool.hpp" // BS::synced_stream, BS::thread_pool
+#include "ModelPreflight.h"
+
+#include <algorithm>
+#include <chrono> // for std::chrono functions
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Checks every .osim below <directory_path> for the problems that otherwise
+// surface as Simbody exceptions deep inside a bulk run (see
+// IMUIKTriangleInequality) and writes them to a CSV report. Exits non-zero if
+// any model is rejected.
+
+BS::synced_stream sync_out(std::cout);
+
+const std::string defaultReportFile = "model_preflight.csv";
+
+void collectModels(const std::filesystem::path &directory,
+                   std::vector<std::filesystem::path> &files) {
+  for (const auto &entry :
+       std::filesystem::recursive_directory_iterator(directory)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".osim") {
+      files.push_back(entry.path());
+    }
+  }
+  std::sort(files.begin(), files.end());
+}
+
+int main(int argc, char *argv[]) {
+  std::chrono::steady_clock::time_point begin =
+      std::chrono::steady_clock::now();
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <directory_path> [report_file]"
+              << std::endl;
+    return 1;
+  }
+
+  std::filesystem::path directoryPath = argv[1];
+  if (!std::filesystem::exists(directoryPath) ||
+      !std::filesystem::is_directory(directoryPath)) {
+    std::cerr << "The provided path is not a valid directory: "
+              << directoryPath << std::endl;
+    return 1;
+  }
+  const std::filesystem::path reportFile =
+      argc > 2 ? argv[2] : defaultReportFile;
+
+  std::vector<std::filesystem::path> models;
+  collectModels(directoryPath, models);
+
+  // Threading
+  const int max_threads = 64;
+  const int num_threads = std::thread::hardware_concurrency() > max_threads
+                              ? max_threads
+                              : std::thread::hardware_concurrency();
+  BS::thread_pool pool(num_threads);
+  sync_out.println("Thread Pool num threads: ", pool.get_thread_count(),
+                   " Models: ", models.size());
+
+  std::vector<std::future<std::vector<PreflightIssue>>> results;
+  results.reserve(models.size());
+  for (const auto &model : models) {
+    results.push_back(pool.submit_task([model] {
+      return preflightModel(model);
+    }));
+  }
+
+  // Collected in file order so the report is reproducible
+  std::vector<PreflightIssue> issues;
+  std::set<std::string> rejected;
+  for (auto &result : results) {
+    for (PreflightIssue &issue : result.get()) {
+      sync_out.println(issue.file, ":", issue.line, " ", issue.check, " ",
+                       issue.component, " ", issue.detail);
+      rejected.insert(issue.file);
+      issues.push_back(std::move(issue));
+    }
+  }
+
+  std::ofstream report(reportFile);
+  if (!report) {
+    std::cerr << "Could not write report: " << reportFile << std::endl;
+    return 1;
+  }
+  writePreflightReport(report, issues);
+  sync_out.println("Report: ", reportFile.string(), " Issues: ", issues.size());
+
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  const double runtime =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+          .count();
+  sync_out.println("Runtime = ", runtime, " [µs]");
+  if (!rejected.empty()) {
+    sync_out.println("Rejected ", rejected.size(), " of ", models.size(),
+                     " models");
+    return 1;
+  }
+  sync_out.println("Finished Running without Error!");
+  return 0;
+}
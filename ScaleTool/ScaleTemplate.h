@@ -0,0 +1,330 @@
+#ifndef OPENSIM_SCALE_TEMPLATE_H_
+#define OPENSIM_SCALE_TEMPLATE_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  ScaleTemplate.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Common/MarkerData.h>
+#include <OpenSim/Common/Units.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Tools/GenericModelMaker.h>
+#include <OpenSim/Tools/ScaleTool.h>
+
+#include "MarkerDistanceKernel.h"
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Static trial of one participant, loaded once and shared by every template
+// scaled for that participant. Marker-pair distances are taken with a
+// MarkerDistanceKernel per length unit: the pairs of all templates'
+// measurements are computed for every frame in one SIMD pass, and each
+// measurement only averages its frames.
+class StaticTrial {
+public:
+    explicit StaticTrial(const std::string& markerFile)
+        : _markerData(markerFile) {}
+
+    // Registers the marker pairs of `measurements` so that they are part of
+    // the first distance pass.
+    void addMeasurements(OpenSim::MeasurementSet& measurements,
+            const OpenSim::Units& units) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        MarkerDistanceKernel& kernel = trialIn(units).kernel;
+        for (int i = 0; i < measurements.getSize(); ++i) {
+            const OpenSim::Measurement& measurement = measurements.get(i);
+            for (int j = 0; j < measurement.getNumMarkerPairs(); ++j) {
+                const OpenSim::MarkerPair& pair = measurement.getMarkerPair(j);
+                kernel.addPair(pair.getMarkerName(0), pair.getMarkerName(1));
+            }
+        }
+    }
+
+    // ModelScaler::takeExperimentalMarkerMeasurement() of `scaler` on the
+    // trial converted to `units`.
+    double experimentalDistance(const OpenSim::ModelScaler& scaler,
+            const OpenSim::Units& units, const std::string& name1,
+            const std::string& name2, const std::string& measurementName) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Trial& trial = trialIn(units);
+        const int pair = trial.kernel.addPair(name1, name2);
+        if (pair < 0) {
+            // Let the scaler report the missing marker
+            return scaler.takeExperimentalMarkerMeasurement(
+                trial.markerData, name1, name2, measurementName);
+        }
+        trial.kernel.compute();
+        const OpenSim::Array<double>& timeRange = scaler.getTimeRange();
+        int startFrame = 0, endFrame = 0;
+        trial.markerData.findFrameRange(
+            timeRange[0], timeRange[1], startFrame, endFrame);
+        return trial.kernel.meanDistance(pair, startFrame, endFrame);
+    }
+
+private:
+    struct Trial {
+        explicit Trial(const OpenSim::MarkerData& data)
+            : markerData(data), kernel(markerData) {}
+        OpenSim::MarkerData markerData;
+        MarkerDistanceKernel kernel;
+    };
+
+    // Trial in the given units, converted and loaded into a kernel once
+    Trial& trialIn(const OpenSim::Units& units) {
+        std::unique_ptr<Trial>& trial = _trials[units.getAbbreviation()];
+        if (!trial) {
+            OpenSim::MarkerData converted(_markerData);
+            converted.convertToUnits(units);
+            trial = std::make_unique<Trial>(converted);
+        }
+        return *trial;
+    }
+
+    const OpenSim::MarkerData _markerData;
+    std::map<std::string, std::unique_ptr<Trial>> _trials;
+    std::mutex _mutex;
+};
+
+// Generic model with its scaling marker set, loaded once (exactly as
+// GenericModelMaker::processModel() does) and shared read-only between
+// participants. Each participant scales its own clone in memory, so the
+// generic files are never copied or parsed again and repeated
+// updateMarkerSet() calls on freshly loaded models are avoided.
+class ScaleTemplate {
+public:
+    // Generic model and marker set named by the GenericModelMaker of a
+    // ScaleTool setup file; the setup is kept for scaleParticipant().
+    explicit ScaleTemplate(const std::string& setupFile)
+        : _setup(std::make_unique<OpenSim::ScaleTool>(setupFile)) {
+        _model.reset(_setup->getGenericModelMaker().processModel(
+            _setup->getPathToSubject()));
+        OPENSIM_THROW_IF(!_model, OpenSim::Exception,
+            "Could not load the generic model of " + setupFile);
+    }
+
+    // Generic model and marker set given directly (no setup).
+    ScaleTemplate(const std::string& modelFile, const std::string& markerSetFile) {
+        OpenSim::GenericModelMaker genericModelMaker;
+        genericModelMaker.setModelFileName(modelFile);
+        genericModelMaker.setMarkerSetFileName(markerSetFile);
+        _model.reset(genericModelMaker.processModel(
+            OpenSim::IO::getParentDirectory(modelFile)));
+        OPENSIM_THROW_IF(!_model, OpenSim::Exception,
+            "Could not load the generic model " + modelFile);
+    }
+
+    const OpenSim::Model& getModel() const { return *_model; }
+
+    // Registers the setup's measurements with a participant's static trial
+    void addMeasurementsTo(StaticTrial& staticTrial) const {
+        OPENSIM_THROW_IF(!_setup, OpenSim::Exception,
+            "ScaleTemplate was created without a ScaleTool setup.");
+        staticTrial.addMeasurements(
+            _setup->getModelScaler().getMeasurementSet(), _model->getLengthUnits());
+    }
+
+    // Initialized copy of the generic model (marker set included).
+    std::unique_ptr<OpenSim::Model> cloneModel() const {
+        std::unique_ptr<OpenSim::Model> model;
+        {
+            // Copying reads the template's components; serialize it so
+            // participants on other threads never see a half-built copy.
+            std::lock_guard<std::mutex> lock(_cloneMutex);
+            model.reset(_model->clone());
+        }
+        model->initSystem();
+        return model;
+    }
+
+    // The ModelScaler and MarkerPlacer steps of ScaleTool::run() applied to
+    // a clone of the template. Marker files and outputs of the setup are
+    // resolved against `pathToSubject`; output file names are prefixed with
+    // `outputPrefix`. With a `staticTrial` the measurements are taken from
+    // it instead of loading the scaler's marker file. Returns false if a
+    // step fails.
+    bool scaleParticipant(const std::string& pathToSubject, double mass,
+            StaticTrial* staticTrial = nullptr,
+            const std::string& outputPrefix = "") const {
+        OPENSIM_THROW_IF(!_setup, OpenSim::Exception,
+            "ScaleTemplate was created without a ScaleTool setup.");
+        std::unique_ptr<OpenSim::Model> model = cloneModel();
+        model->setName(_setup->getName());
+
+        // Copies, as the placer keeps per-run state in the object
+        OpenSim::ModelScaler modelScaler(_setup->getModelScaler());
+        OpenSim::MarkerPlacer markerPlacer(_setup->getMarkerPlacer());
+        if (!outputPrefix.empty()) {
+            prefixOutputs(modelScaler, markerPlacer, outputPrefix);
+        }
+        if (modelScaler.getApply()) {
+            const bool scaled = staticTrial
+                ? scaleModel(*model, modelScaler, pathToSubject, mass, *staticTrial)
+                : modelScaler.processModel(model.get(), pathToSubject, mass);
+            if (!scaled) {
+                return false;
+            }
+        }
+        if (markerPlacer.getApply() &&
+                !markerPlacer.processModel(model.get(), pathToSubject)) {
+            return false;
+        }
+        return true;
+    }
+
+    // ModelScaler::computeMeasurementScaleFactor(): mean over the marker
+    // pairs of `ratio(name1, name2)`, the experimental to model length. NaN
+    // without pairs, so the measurement is skipped rather than applied as 0.
+    template <typename Ratio>
+    static double measurementScaleFactor(const OpenSim::Measurement& measurement,
+            Ratio&& ratio) {
+        const int numPairs = measurement.getNumMarkerPairs();
+        if (numPairs == 0) {
+            return SimTK::NaN;
+        }
+        double scaleFactor = 0;
+        for (int k = 0; k < numPairs; ++k) {
+            const OpenSim::MarkerPair& pair = measurement.getMarkerPair(k);
+            scaleFactor += ratio(pair.getMarkerName(0), pair.getMarkerName(1));
+        }
+        return scaleFactor / numPairs;
+    }
+
+private:
+    static bool isAssigned(const std::string& fileName) {
+        return !fileName.empty() && fileName != "Unassigned";
+    }
+
+    static void prefixOutputs(OpenSim::ModelScaler& modelScaler,
+            OpenSim::MarkerPlacer& markerPlacer, const std::string& prefix) {
+        if (isAssigned(modelScaler.getOutputModelFileName())) {
+            modelScaler.setOutputModelFileName(
+                prefix + modelScaler.getOutputModelFileName());
+        }
+        if (isAssigned(modelScaler.getOutputScaleFileName())) {
+            modelScaler.setOutputScaleFileName(
+                prefix + modelScaler.getOutputScaleFileName());
+        }
+        if (isAssigned(markerPlacer.getOutputModelFileName())) {
+            markerPlacer.setOutputModelFileName(
+                prefix + markerPlacer.getOutputModelFileName());
+        }
+        if (isAssigned(markerPlacer.getOutputMotionFileName())) {
+            markerPlacer.setOutputMotionFileName(
+                prefix + markerPlacer.getOutputMotionFileName());
+        }
+        if (isAssigned(markerPlacer.getOutputMarkerFileName())) {
+            markerPlacer.setOutputMarkerFileName(
+                prefix + markerPlacer.getOutputMarkerFileName());
+        }
+    }
+
+    // ModelScaler::processModel() step for step, with the measurements taken
+    // from the shared static trial.
+    static bool scaleModel(OpenSim::Model& model,
+            OpenSim::ModelScaler& modelScaler, const std::string& pathToSubject,
+            double mass, StaticTrial& staticTrial) {
+        OpenSim::ScaleSet scaleSet;
+        for (const OpenSim::PhysicalFrame& frame :
+                model.getComponentList<OpenSim::PhysicalFrame>()) {
+            OpenSim::Scale* scale = new OpenSim::Scale();
+            scale->setSegmentName(frame.getName());
+            scale->setScaleFactors(SimTK::Vec3(1.0));
+            scale->setApply(true);
+            scaleSet.adoptAndAppend(scale);
+        }
+
+        SimTK::State& s = model.initSystem();
+        model.getMultibodySystem().realize(s, SimTK::Stage::Position);
+
+        try {
+            const OpenSim::Array<std::string>& scalingOrder =
+                modelScaler.getScalingOrder();
+            for (int i = 0; i < scalingOrder.getSize(); ++i) {
+                if (scalingOrder[i] == "measurements") {
+                    OpenSim::MeasurementSet& measurements =
+                        modelScaler.getMeasurementSet();
+                    for (int j = 0; j < measurements.getSize(); ++j) {
+                        OpenSim::Measurement& measurement = measurements.get(j);
+                        if (!measurement.getApply()) {
+                            continue;
+                        }
+                        const double scaleFactor = measurementScaleFactor(measurement,
+                            [&](const std::string& name1, const std::string& name2) {
+                                const double modelLength = modelScaler.takeModelMeasurement(
+                                    s, model, name1, name2, measurement.getName());
+                                const double experimentalLength = staticTrial.experimentalDistance(
+                                    modelScaler, model.getLengthUnits(), name1, name2,
+                                    measurement.getName());
+                                return experimentalLength / modelLength;
+                            });
+                        if (!SimTK::isNaN(scaleFactor)) {
+                            measurement.applyScaleFactor(scaleFactor, scaleSet);
+                        } else {
+                            std::cerr << "Scale factor for " << measurement.getName()
+                                      << " was not computed" << std::endl;
+                        }
+                    }
+                } else if (scalingOrder[i] == "manualScale") {
+                    const OpenSim::ScaleSet& manualScales = modelScaler.getScaleSet();
+                    for (int j = 0; j < manualScales.getSize(); ++j) {
+                        if (!manualScales[j].getApply()) {
+                            continue;
+                        }
+                        SimTK::Vec3 factors(1.0);
+                        manualScales[j].getScaleFactors(factors);
+                        for (int k = 0; k < scaleSet.getSize(); ++k) {
+                            if (scaleSet[k].getSegmentName() == manualScales[j].getSegmentName()) {
+                                scaleSet[k].setScaleFactors(factors);
+                            }
+                        }
+                    }
+                } else {
+                    throw OpenSim::Exception("ModelScaler: ERR- Unrecognized string '" +
+                        scalingOrder[i] + "' in ScalingOrder property", __FILE__, __LINE__);
+                }
+            }
+
+            model.scale(s, scaleSet, modelScaler.getPreserveMassDist(), mass);
+
+            if (isAssigned(modelScaler.getOutputModelFileName())) {
+                model.print(pathToSubject + modelScaler.getOutputModelFileName());
+            }
+            if (isAssigned(modelScaler.getOutputScaleFileName())) {
+                scaleSet.print(pathToSubject + modelScaler.getOutputScaleFileName());
+            }
+        } catch (const OpenSim::Exception& x) {
+            x.print(std::cerr);
+            return false;
+        }
+        return true;
+    }
+
+    std::unique_ptr<OpenSim::ScaleTool> _setup;
+    std::unique_ptr<OpenSim::Model> _model;
+    mutable std::mutex _cloneMutex;
+};
+
+#endif // OPENSIM_SCALE_TEMPLATE_H_
@@ -28,6 +28,8 @@
 #include <OpenSim/Common/TRCFileAdapter.h>
 #include <OpenSim/Tools/ScaleTool.h>
 
+#include "ScaleTemplate.h"
+
 
 #include <string>
 #include <sstream>
@@ -35,6 +37,7 @@
 #include <iostream>
 #include <clocale>
 #include <chrono> // for std::chrono functions
+#include <iomanip>
 #include <vector>
 
 struct Participant {
@@ -56,18 +59,101 @@ void rotateMarkerTable(
         OpenSim::TimeSeriesTableVec3& table,
         const SimTK::Rotation_<double>& rotationMatrix)
 {
+    // In place, column by column: the table's Vec3 matrix is column-major
     const SimTK::Rotation R_XG = rotationMatrix;
+    SimTK::Matrix_<SimTK::Vec3>& matrix = table.updMatrix();
+    for (int j = 0; j < matrix.ncol(); ++j) {
+        for (int i = 0; i < matrix.nrow(); ++i) {
+            matrix(i, j) = R_XG * matrix(i, j);
+        }
+    }
+}
 
-    int nc = int(table.getNumColumns());
-    size_t nt = table.getNumRows();
+// Scale factors of the setup's measurements as ScaleToolBulk takes them
+// (ScaleTemplate::measurementScaleFactor over a StaticTrial) must equal
+// ModelScaler::computeMeasurementScaleFactor() bit for bit on the static trial
+// of the setup. Two extra measurements cover the cases without a valid pair:
+// one without pairs and one whose markers are not in the trial.
+bool checkMeasurementKernel(OpenSim::ScaleTool& setup)
+{
+    const std::string pathToSubject = setup.getPathToSubject();
+    std::unique_ptr<OpenSim::Model> model(
+        setup.getGenericModelMaker().processModel(pathToSubject));
+    SimTK::State& s = model->initSystem();
+    model->getMultibodySystem().realize(s, SimTK::Stage::Position);
+
+    OpenSim::ModelScaler& modelScaler = setup.getModelScaler();
+    const std::string markerFile = pathToSubject + modelScaler.getMarkerFileName();
+    OpenSim::MarkerData markerData(markerFile);
+    markerData.convertToUnits(model->getLengthUnits());
+
+    OpenSim::MeasurementSet measurements(modelScaler.getMeasurementSet());
+    OpenSim::Measurement noPairs;
+    noPairs.setName("check_no_pairs");
+    measurements.cloneAndAppend(noPairs);
+    OpenSim::Measurement missingMarkers;
+    missingMarkers.setName("check_missing_markers");
+    missingMarkers.getMarkerPairSet().cloneAndAppend(
+        OpenSim::MarkerPair("check_missing_1", "check_missing_2"));
+    measurements.cloneAndAppend(missingMarkers);
+
+    // Both throw on markers missing from the trial; that counts as NaN
+    auto orNaN = [](auto&& compute) {
+        try {
+            return compute();
+        } catch (const OpenSim::Exception&) {
+            return SimTK::NaN;
+        }
+    };
 
-    for (size_t i = 0; i < nt; ++i) {
-        auto row = table.updRowAtIndex(i);
-        for (int j = 0; j < nc; ++j) {
-            row[j] = R_XG * row[j];
+    // All pairs in one pass, then the per-measurement ratios
+    StaticTrial staticTrial(markerFile);
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    staticTrial.addMeasurements(measurements, model->getLengthUnits());
+    std::vector<double> kernelFactors;
+    for (int i = 0; i < measurements.getSize(); ++i) {
+        const OpenSim::Measurement& measurement = measurements.get(i);
+        kernelFactors.push_back(orNaN([&] {
+            return ScaleTemplate::measurementScaleFactor(measurement,
+                [&](const std::string& name1, const std::string& name2) {
+                    return staticTrial.experimentalDistance(modelScaler,
+                               model->getLengthUnits(), name1, name2,
+                               measurement.getName()) /
+                           modelScaler.takeModelMeasurement(
+                               s, *model, name1, name2, measurement.getName());
+                });
+        }));
+    }
+    std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+
+    std::vector<double> referenceFactors;
+    for (int i = 0; i < measurements.getSize(); ++i) {
+        referenceFactors.push_back(orNaN([&] {
+            return modelScaler.computeMeasurementScaleFactor(
+                s, *model, markerData, measurements.get(i));
+        }));
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    bool identical = true;
+    for (int i = 0; i < measurements.getSize(); ++i) {
+        const bool same = kernelFactors[i] == referenceFactors[i] ||
+            (SimTK::isNaN(kernelFactors[i]) && SimTK::isNaN(referenceFactors[i]));
+        if (!same) {
+            std::cout << std::setprecision(17) << "Scale factor of "
+                      << measurements.get(i).getName() << " differs: ScaleTemplate "
+                      << kernelFactors[i] << " ModelScaler " << referenceFactors[i]
+                      << std::endl;
         }
+        identical = identical && same;
     }
-    return;
+    std::cout << "ScaleTemplate " << (identical ? "matches" : "DIFFERS")
+              << " ModelScaler, kernel = "
+              << std::chrono::duration_cast<std::chrono::microseconds>(middle - begin).count()
+              << "[µs], ModelScaler = "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count()
+              << "[µs]" << std::endl;
+    return identical;
 }
 
 int main()
@@ -109,11 +195,13 @@ int main()
     // Keep track of the folder containing setup file, will be used to locate results to compare against
     const std::string setupFilePath=subject->getPathToSubject();
 
+    const bool kernelMatches = checkMeasurementKernel(*subject);
+
     subject->run();
 
    
     std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
     std::cout << "Runtime = " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << "[µs]" << std::endl;
     std::cout << "Finished Running without Error!" << std::endl;
-    // return 0;
+    return kernelMatches ? 0 : 1;
 }
@@ -0,0 +1,198 @@
+#ifndef OPENSIM_PARTICIPANT_STORE_H_
+#define OPENSIM_PARTICIPANT_STORE_H_
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  ParticipantStore.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2025 Stanford University and the Authors                *
+ * Author(s): Alex Beattie                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// One row of info_participants.csv (Kuopio gait dataset)
+struct Participant {
+  int ID;
+  int Age;
+  char Gender; // 'M' or 'F'
+  char Leg;    // 'L' or 'R'
+  double Height;
+  int IAD;
+  int Left_knee_width;
+  int Right_knee_width;
+  int Left_ankle_width;
+  int Right_ankle_width;
+  int Left_thigh_length;
+  int Right_thigh_length;
+  int Left_shank_length;
+  int Right_shank_length;
+  double Mass;
+  double ICD;
+  double Left_knee_width_mocap;
+  double Right_knee_width_mocap;
+  std::set<std::string> Invalid_trials; // e.g. "r_comf_01"
+};
+
+// Participant table loaded once and indexed by study ID. Bulk tools ask it
+// whether a task can succeed before scheduling it, so invalid trials and
+// participants without the needed data never reach a worker.
+class ParticipantStore {
+public:
+  explicit ParticipantStore(const std::string &fileName) {
+    std::ifstream file(fileName);
+    if (!file) {
+      throw std::runtime_error("Could not open participants file: " +
+                               fileName);
+    }
+    std::string line;
+    // Skip the header line
+    std::getline(file, line);
+    while (std::getline(file, line)) {
+      if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+      }
+      if (line.empty()) {
+        continue;
+      }
+      try {
+        add(parseRow(line));
+      } catch (const std::exception &e) {
+        std::cerr << "Error parsing line: " << line << "\n"
+                  << e.what() << std::endl;
+      }
+    }
+  }
+
+  const std::vector<Participant> &getParticipants() const {
+    return _participants;
+  }
+
+  // nullptr if the ID is not in the table
+  const Participant *find(int id) const {
+    const auto it = _index.find(id);
+    return it == _index.end() ? nullptr : &_participants[it->second];
+  }
+
+  // By dataset directory name ("01"); nullptr if not a known ID
+  const Participant *find(const std::string &directoryName) const {
+    int id = 0;
+    const char *first = directoryName.data();
+    const char *last = first + directoryName.size();
+    const auto [ptr, ec] = std::from_chars(first, last, id);
+    if (ec != std::errc() || ptr != last) {
+      return nullptr;
+    }
+    return find(id);
+  }
+
+  // Trial name ("l_comf_01") within a file stem such as
+  // "data_l_comf_01_orientations"; empty if there is none
+  static std::string trialOf(const std::string &fileStem) {
+    static const std::regex pattern(R"([rl]_(fast|slow|comf)_\d{2})");
+    std::smatch match;
+    return std::regex_search(fileStem, match, pattern) ? match.str(0) : "";
+  }
+
+  // Whether a task on `fileStem` of the participant in `directoryName` can
+  // succeed: the participant is known and the trial is not listed as invalid.
+  // Which data a participant has is decided by the files a tool collects.
+  bool isRunnable(const std::string &directoryName,
+                  const std::string &fileStem) const {
+    const Participant *participant = find(directoryName);
+    if (!participant) {
+      return false;
+    }
+    const std::string trial = trialOf(fileStem);
+    return trial.empty() || participant->Invalid_trials.count(trial) == 0;
+  }
+
+private:
+  void add(Participant participant) {
+    if (!_index.emplace(participant.ID, _participants.size()).second) {
+      throw std::runtime_error("Duplicate participant ID " +
+                               std::to_string(participant.ID));
+    }
+    _participants.push_back(std::move(participant));
+  }
+
+  // Fields of a CSV line; quoted fields may contain commas
+  static std::vector<std::string> splitFields(const std::string &line) {
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (const char c : line) {
+      if (c == '"') {
+        quoted = !quoted;
+      } else if (c == ',' && !quoted) {
+        fields.emplace_back();
+      } else {
+        fields.back() += c;
+      }
+    }
+    return fields;
+  }
+
+  static Participant parseRow(const std::string &line) {
+    const std::vector<std::string> fields = splitFields(line);
+    if (fields.size() < 18) {
+      throw std::invalid_argument("expected at least 18 fields, got " +
+                                  std::to_string(fields.size()));
+    }
+    Participant p;
+    p.ID = std::stoi(fields[0]);
+    p.Age = std::stoi(fields[1]);
+    p.Gender = fields[2].at(0);
+    p.Leg = fields[3].at(0);
+    p.Height = std::stod(fields[4]);
+    p.IAD = std::stoi(fields[5]);
+    p.Left_knee_width = std::stoi(fields[6]);
+    p.Right_knee_width = std::stoi(fields[7]);
+    p.Left_ankle_width = std::stoi(fields[8]);
+    p.Right_ankle_width = std::stoi(fields[9]);
+    p.Left_thigh_length = std::stoi(fields[10]);
+    p.Right_thigh_length = std::stoi(fields[11]);
+    p.Left_shank_length = std::stoi(fields[12]);
+    p.Right_shank_length = std::stoi(fields[13]);
+    p.Mass = std::stod(fields[14]);
+    p.ICD = std::stod(fields[15]);
+    p.Left_knee_width_mocap = std::stod(fields[16]);
+    p.Right_knee_width_mocap = std::stod(fields[17]);
+    if (fields.size() > 18) {
+      // Invalid trials are one quoted, comma separated field
+      for (const std::string &trial : splitFields(fields[18])) {
+        if (!trial.empty()) {
+          p.Invalid_trials.insert(trial);
+        }
+      }
+    }
+    return p;
+  }
+
+  std::vector<Participant> _participants;
+  std::unordered_map<int, std::size_t> _index;
+};
+
+#endif // OPENSIM_PARTICIPANT_STORE_H_
@@ -27,11 +27,14 @@
 #include <OpenSim/Common/TRCFileAdapter.h>
 #include <OpenSim/Tools/ScaleTool.h>
 
-#include <algorithm> // For std::find_if
+#include "ParticipantStore.h"
+#include "ScaleTemplate.h"
+
 #include <chrono> // for std::chrono functions
 #include <clocale>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -46,101 +49,49 @@ const std::string fileNameParticipants = "info_participants.csv";
 const std::string fileNameCalibration = "calib_static_markers.trc";
 const std::string fileNameModel = "gait2392_thelen2003muscle.osim";
 const std::string fileNameMarkerSet = "kg_gait2392_thelen2003muscle_Scale_MarkerSet.xml";
+const std::string fileNameSetupScale = "kg_gait_gait2392_thelen2003muscle_Setup_Scale.xml";
+// Setups scaled in one pass over the static trial by --templates. Only the
+// gait2392 setup ships in data/; other setups (with their model and marker
+// set next to them) are passed as a list on the command line.
+const std::vector<std::string> fileNamesSetupScale = {
+    "kg_gait_gait2392_thelen2003muscle_Setup_Scale.xml",
+};
 // Rotation from marker space to OpenSim space (y is up)
 // This is the rotation for the kuopio gait dataset
 const SimTK::Vec3 rotations(-SimTK::Pi/2,SimTK::Pi/2,0);
 
-struct Participant {
-    int ID;
-    int Age;
-    char Gender; // 'M' or 'F'
-    char Leg; // Assuming 'L' or 'R'
-    double Height;
-    std::vector<std::string> Invalid_trials; // Store invalid trials as a vector of strings
-    int IAD;
-    int Left_knee_width;
-    int Right_knee_width;
-    int Left_ankle_width;
-    int Right_ankle_width;
-    int Left_thigh_length;
-    int Right_thigh_length;
-    int Left_shank_length;
-    int Right_shank_length;
-    double Mass;
-    double ICD;
-    double Left_knee_width_mocap;
-    double Right_knee_width_mocap;
-};
-
-std::vector<Participant> parseCSV(const std::string& filename) {
-    std::vector<Participant> participants;
-    std::ifstream file(filename);
-    std::string line;
-
-    // Skip the header line
-    if (std::getline(file, line)) {
-        // Process each line in the CSV file
-        while (std::getline(file, line)) {
-            std::istringstream ss(line);
-            Participant participant;
-            std::string invalid_trials;
-
-            // Read each field separated by commas
-            std::string token;
-            try {
-              std::getline(ss, token, ','); participant.ID = std::stoi(token);
-              std::getline(ss, token, ','); participant.Age = std::stoi(token);
-              std::getline(ss, token, ','); participant.Gender = token[0];
-              std::getline(ss, token, ','); participant.Leg = token[0]; // Assuming single character
-              std::getline(ss, token, ','); participant.Height = std::stod(token);
-              std::getline(ss, token, ','); participant.IAD = std::stoi(token);
-              std::getline(ss, token, ','); participant.Left_knee_width = std::stoi(token);
-              std::getline(ss, token, ','); participant.Right_knee_width = std::stoi(token);
-              std::getline(ss, token, ','); participant.Left_ankle_width = std::stoi(token);
-              std::getline(ss, token, ','); participant.Right_ankle_width = std::stoi(token);
-              std::getline(ss, token, ','); participant.Left_thigh_length = std::stoi(token);
-              std::getline(ss, token, ','); participant.Right_thigh_length = std::stoi(token);
-              std::getline(ss, token, ','); participant.Left_shank_length = std::stoi(token);
-              std::getline(ss, token, ','); participant.Right_shank_length = std::stoi(token);
-              std::getline(ss, token, ','); participant.Mass = std::stod(token);
-              std::getline(ss, token, ','); participant.ICD = std::stod(token);
-              std::getline(ss, token, ','); participant.Left_knee_width_mocap = std::stod(token);
-              std::getline(ss, token, ','); participant.Right_knee_width_mocap = std::stod(token);
-
-              std::getline(ss, invalid_trials, ','); // Read the invalid trials as a single string
-              // std::istringstream invalid_ss(invalid_trials);
-              // while (std::getline(invalid_ss, token, ',')) {
-              //     participant.Invalid_trials.push_back(token);
-              // }
-              } catch (const std::invalid_argument& e) {
-                std::cerr << "Error parsing line: " << line << "\n" << e.what() << std::endl;
-                continue; // Skip this line and continue
-              }
-            // Add the participant to the vector
-            participants.push_back(participant);
-        }
-    }
-
-    return participants;
-}
-
 // Function to rotate a table of Vec3 elements
 void rotateMarkerTable(
         OpenSim::TimeSeriesTableVec3& table,
         const SimTK::Rotation_<double>& rotationMatrix)
 {
+    // In place, column by column: the table's Vec3 matrix is column-major
     const SimTK::Rotation R_XG = rotationMatrix;
+    SimTK::Matrix_<SimTK::Vec3>& matrix = table.updMatrix();
+    for (int j = 0; j < matrix.ncol(); ++j) {
+        for (int i = 0; i < matrix.nrow(); ++i) {
+            matrix(i, j) = R_XG * matrix(i, j);
+        }
+    }
+}
 
-    int nc = int(table.getNumColumns());
-    size_t nt = table.getNumRows();
+// Generic model every participant is scaled to. Outputs are prefixed with
+// the setup name when several templates share a result directory.
+struct NamedTemplate {
+  std::string outputPrefix;
+  std::unique_ptr<ScaleTemplate> scaleTemplate;
+};
 
-    for (size_t i = 0; i < nt; ++i) {
-        auto row = table.updRowAtIndex(i);
-        for (int j = 0; j < nc; ++j) {
-            row[j] = R_XG * row[j];
-        }
+std::vector<std::string> splitList(const std::string &list) {
+  std::vector<std::string> items;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
     }
-    return;
+  }
+  return items;
 }
 
 std::string getTwoDigitString(int number) {
@@ -156,8 +107,11 @@ std::string getTwoDigitString(int number) {
     return oss.str(); // Return the formatted string
 }
 
+// scaleTemplates: shared generic models to scale in memory, or empty to copy
+// the generic files and run a ScaleTool per participant
 void process(
-    const fs::path &sourceDir, const fs::path &resultDir, const std::string &fileStem, const Participant participant) {
+    const fs::path &sourceDir, const fs::path &resultDir, const std::string &fileStem, const Participant participant,
+    const std::vector<NamedTemplate> &scaleTemplates) {
   std::cout << "---Starting Processing: " << sourceDir << " stem: " << fileStem << " Participant: " << participant.ID << std::endl;
   try {
     // OpenSim::IO::SetDigitsPad(4);
@@ -194,6 +148,38 @@ void process(
     
     trcfileadapter.write(table, markerFileName);
 
+    if (!scaleTemplates.empty()) {
+      // Scale a clone of each shared generic model concurrently; the rotated
+      // static trial is loaded once and the marker-pair distances of all
+      // templates are computed together. Only the scaled outputs are written.
+      const std::string pathToSubject = (newDirectory / "").string();
+      StaticTrial staticTrial(markerFileName);
+      for (const NamedTemplate &t : scaleTemplates) {
+        t.scaleTemplate->addMeasurementsTo(staticTrial);
+      }
+      std::vector<std::future<bool>> scaled;
+      for (const NamedTemplate &t : scaleTemplates) {
+        scaled.push_back(std::async(std::launch::async, [&, &t = t]() {
+          return t.scaleTemplate->scaleParticipant(
+              pathToSubject, participant.Mass, &staticTrial, t.outputPrefix);
+        }));
+      }
+      for (std::size_t i = 0; i < scaled.size(); ++i) {
+        bool ok = false;
+        try {
+          ok = scaled[i].get();
+        } catch (const std::exception &e) {
+          std::cerr << "Error in scaling: " << e.what() << std::endl;
+        }
+        if (!ok) {
+          std::cerr << "Scaling failed for participant: " << participant.ID
+                    << " template: " << i << std::endl;
+        }
+      }
+      std::cout << "-------Finished Result: " << resultDir << std::endl;
+      return;
+    }
+
     // Copy over the model
     const std::filesystem::path modelSourcePath(fileNameModel);
     const std::filesystem::path markerSetSourcePath(fileNameMarkerSet);
@@ -207,7 +193,6 @@ void process(
         std::cerr << "Error copying file: " << e.what() << std::endl;
     }
     // Construct model and read parameters file
-    const std::string fileNameSetupScale = "kg_gait_gait2392_thelen2003muscle_Setup_Scale.xml";
     // const std::string fileNameModelScaler = "kg_gait_gait2392_thelen2003muscle_Setup_Model_Scaler.xml";
 
     // std::unique_ptr<OpenSim::ModelScaler> modelScaler(new OpenSim::ModelScaler());
@@ -263,14 +248,15 @@ void process(
   std::cout << "-------Finished Result: " << resultDir << std::endl;
 }
 
-void processDirectory(const fs::path &dirPath, const fs::path &resultPath, std::vector<Participant>& participants) {
+void processDirectory(const fs::path &dirPath, const fs::path &resultPath, const ParticipantStore &participants,
+                      const std::vector<NamedTemplate> &scaleTemplates) {
 
   std::vector<std::thread> threads;
   // Iterate through the directory
   for (const auto &entry : fs::directory_iterator(dirPath)) {
     if (entry.is_directory()) {
       // Recursively process subdirectory
-      processDirectory(entry.path(), resultPath, participants);
+      processDirectory(entry.path(), resultPath, participants, scaleTemplates);
     } else if (entry.is_regular_file()) {
       // Check if the file has a .mat extension
       // std::cout << entry.path().filename() << std::endl;
@@ -283,19 +269,13 @@ void processDirectory(const fs::path &dirPath, const fs::path &resultPath, std::
 
         const std::filesystem::path resultDir =
             resultPath / secondParent.filename() / firstParent.filename() / "";
-        const int participantId = std::stoi(secondParent.filename());
-        // std::cout << "Participant: " << participantId << std::endl;
-        auto it = std::find_if(participants.begin(), 
-             participants.end(), 
-             [&cp = participantId]
-             (const Participant& p) { return cp == p.ID; }); 
-        // Find the correct participant from the participants vector
-        // Output the found participant or a message if not found
-        if (it != participants.end()) {
-          // std::cout << "Found Participant: " << std::endl;
-          const Participant participant = *it;
+        // Find the participant by its directory name; unknown ones are
+        // skipped before a thread is started
+        const Participant *participant =
+            participants.find(secondParent.filename().string());
+        if (participant) {
           // process(dirPath, resultDir, textFilePath.stem(), participant);
-          threads.emplace_back(process, dirPath, resultDir, textFilePath.stem(), participant);
+          threads.emplace_back(process, dirPath, resultDir, textFilePath.stem(), *participant, std::cref(scaleTemplates));
         }
 
                   
@@ -314,10 +294,23 @@ int main(int argc, char *argv[]) {
   std::chrono::steady_clock::time_point begin =
       std::chrono::steady_clock::now();
   if (argc < 3) {
-    std::cerr << "Usage: " << argv[0] << " <directory_path> <output_path>"
+    std::cerr << "Usage: " << argv[0]
+              << " <directory_path> <output_path> [--shared-template | --templates [setup.xml,...]]"
               << std::endl;
     return 1;
   }
+  // --shared-template: the single setup, scaled from one in-memory template
+  // --templates: several setups (default fileNamesSetupScale) in one pass
+  std::vector<std::string> setupFiles;
+  if (argc > 3 && std::string(argv[3]) == "--shared-template") {
+    setupFiles = {fileNameSetupScale};
+  } else if (argc > 3 && std::string(argv[3]) == "--templates") {
+    setupFiles = argc > 4 ? splitList(argv[4]) : fileNamesSetupScale;
+    if (setupFiles.size() < 2) {
+      std::cout << "Only one setup given to --templates, this is the same as "
+                   "--shared-template" << std::endl;
+    }
+  }
 
   fs::path directoryPath = argv[1];
   if (!fs::exists(directoryPath) || !fs::is_directory(directoryPath)) {
@@ -327,23 +320,31 @@ int main(int argc, char *argv[]) {
 
   fs::path outputPath = argv[2];
 
-  std::vector<Participant> participants = parseCSV(fileNameParticipants);
+  const ParticipantStore participants(fileNameParticipants);
 
   // Output the parsed data
   std::cout << "Participant List: " << std::endl;
-  for (const auto& participant : participants) {
+  for (const auto& participant : participants.getParticipants()) {
       std::cout << "ID: " << participant.ID << ", Age: " << participant.Age
                 << ", Gender: " << participant.Gender << ", Leg: " << participant.Leg
                 << ", Height: " << participant.Height
                 << ", Mass: " << participant.Mass << std::endl;
-      // std::cout << "Invalid Trials: ";
-      // for (const auto& trial : participant.Invalid_trials) {
-      //     std::cout << trial << " ";
-      // }
-      // std::cout << std::endl;
+      std::cout << "Invalid Trials: ";
+      for (const auto& trial : participant.Invalid_trials) {
+          std::cout << trial << " ";
+      }
+      std::cout << std::endl;
+  }
+
+  // Parse each generic model and marker set once for all participants
+  std::vector<NamedTemplate> scaleTemplates;
+  for (const std::string &setupFile : setupFiles) {
+    const std::string prefix =
+        setupFiles.size() > 1 ? fs::path(setupFile).stem().string() + "_" : "";
+    scaleTemplates.push_back({prefix, std::make_unique<ScaleTemplate>(setupFile)});
   }
 
-  processDirectory(directoryPath, outputPath, participants);
+  processDirectory(directoryPath, outputPath, participants, scaleTemplates);
   std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
   std::cout << "Runtime = "
             << std::chrono::duration_cast<std::chrono::microseconds>(end -